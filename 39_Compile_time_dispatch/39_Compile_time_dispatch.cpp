@@ -0,0 +1,187 @@
+#include <iostream>
+#include <vector>
+#include <array>
+#include <tuple>
+#include <utility>
+#include <type_traits>
+#include <cstddef>
+#include <stdexcept>
+#include <chrono>
+#include <random>
+
+// ===============================================================
+// 1. The operations as types instead of function addresses
+// ===============================================================
+// Each operation is an empty struct with a static constexpr apply():
+// the compiler sees the body at every call site and can inline it.
+struct Add {
+    static constexpr const char* name = "add";
+    static constexpr int apply(int a, int b) { return a + b; }
+};
+
+struct Sub {
+    static constexpr const char* name = "sub";
+    static constexpr int apply(int a, int b) { return a - b; }
+};
+
+struct Mul {
+    static constexpr const char* name = "mul";
+    static constexpr int apply(int a, int b) { return a * b; }
+};
+
+struct Divide {
+    static constexpr const char* name = "divide";
+    static constexpr int apply(int a, int b) { return b != 0 ? a / b : 0; } // simple check for division
+};
+
+// Function pointer versions, as in 03_FunctionPointers_3
+int add(int a, int b) { return Add::apply(a, b); }
+int sub(int a, int b) { return Sub::apply(a, b); }
+int mul(int a, int b) { return Mul::apply(a, b); }
+int divide(int a, int b) { return Divide::apply(a, b); }
+
+// ===============================================================
+// 2. DispatchTable: "select op by index" resolved to a type
+// ===============================================================
+template <typename... Ops>
+struct DispatchTable {
+    static constexpr std::size_t size = sizeof...(Ops);
+    static constexpr std::array<const char*, size> names = { Ops::name... };
+
+    // All entry points throw std::out_of_range for index >= size.
+
+    // visit(index, f) calls f(Op{}) for the Op at that index.
+    // The table of thunks is built at compile time from an index_sequence;
+    // inside f the operation is a concrete type, so f's body is fully inlinable.
+    template <typename F>
+    static constexpr decltype(auto) visit(std::size_t index, F&& f) {
+        checkIndex(index);
+        return visitImpl(index, f, std::index_sequence_for<Ops...>{});
+    }
+
+    // Per-call dispatch: a fold over the indices that compilers lower to a switch
+    static constexpr int call(std::size_t index, int a, int b) {
+        checkIndex(index);
+        int result = 0;
+        callImpl(index, a, b, result, std::index_sequence_for<Ops...>{});
+        return result;
+    }
+
+    // Batch dispatch: pick the operation once, then run a loop specialized for it
+    static void apply(std::size_t index, const int* a, const int* b, int* out, std::size_t n) {
+        visit(index, [&](auto op) {
+            using Op = decltype(op);
+            for (std::size_t i = 0; i < n; ++i) {
+                out[i] = Op::apply(a[i], b[i]); // inlined, and vectorized where the ISA allows
+            }
+            });
+    }
+
+private:
+    static constexpr void checkIndex(std::size_t index) {
+        if (index >= size) throw std::out_of_range("DispatchTable: operation index out of range");
+    }
+
+    template <typename F, std::size_t... I>
+    static constexpr decltype(auto) visitImpl(std::size_t index, F& f, std::index_sequence<I...>) {
+        using First = std::tuple_element_t<0, std::tuple<Ops...>>;
+        using R = std::invoke_result_t<F&, First>;
+        using Thunk = R(*)(F&);
+        constexpr Thunk table[] = { [](F& g) -> R { return g(Ops{}); }... };
+        return table[index](f);
+    }
+
+    template <std::size_t... I>
+    static constexpr void callImpl(std::size_t index, int a, int b, int& result, std::index_sequence<I...>) {
+        ((index == I ? (result = Ops::apply(a, b), true) : false) || ...);
+    }
+};
+
+using Calculator = DispatchTable<Add, Sub, Mul, Divide>;
+
+// Everything is constexpr: the table can even be used at compile time
+static_assert(Calculator::size == 4);
+static_assert(Calculator::call(0, 7, 3) == 10);
+static_assert(Calculator::call(3, 7, 0) == 0);
+static_assert(Calculator::visit(2, [](auto op) { return decltype(op)::apply(6, 7); }) == 42);
+
+// ===============================================================
+// 3. Hot loop benchmark: function pointer vs switch vs template
+// ===============================================================
+// Keep the pointer loop out of line so the indirect call survives optimization
+using fPtr = int(*)(int, int);
+
+#if defined(_MSC_VER)
+#define NOINLINE __declspec(noinline)
+#else
+#define NOINLINE __attribute__((noinline))
+#endif
+
+NOINLINE void loopPointer(fPtr op, const int* a, const int* b, int* out, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) out[i] = op(a[i], b[i]);
+}
+
+NOINLINE void loopSwitch(std::size_t choice, const int* a, const int* b, int* out, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) out[i] = Calculator::call(choice, a[i], b[i]);
+}
+
+NOINLINE void loopTemplate(std::size_t choice, const int* a, const int* b, int* out, std::size_t n) {
+    Calculator::apply(choice, a, b, out, n);
+}
+
+template <typename Loop>
+double timeLoop(Loop loop, int repeats) {
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < repeats; ++r) loop();
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> elapsed = end - start;
+    return elapsed.count();
+}
+
+int main() {
+    std::cout << "=== Select an operation by index, resolved at compile time ===\n";
+    for (std::size_t i = 0; i < Calculator::size; ++i) {
+        std::cout << i << " - " << Calculator::names[i] << "(12, 4) = " << Calculator::call(i, 12, 4) << "\n";
+    }
+    try {
+        Calculator::call(Calculator::size, 12, 4);
+    }
+    catch (const std::out_of_range& e) {
+        std::cout << "Invalid choice! (" << e.what() << ")\n";
+    }
+
+    fPtr operations[] = { add, sub, mul, divide };
+
+    const std::size_t N = 1 << 20;
+    const int repeats = 50;
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> dist(-1000, 1000);
+    std::vector<int> a(N), b(N), out1(N), out2(N), out3(N);
+    for (std::size_t i = 0; i < N; ++i) {
+        a[i] = dist(rng);
+        b[i] = dist(rng);
+    }
+
+    // volatile keeps the choice a runtime value, as if it came from std::cin
+    volatile std::size_t choiceSource = 0;
+
+    std::cout << "\n=== Hot loop: " << N << " pairs x " << repeats << " repeats ===\n";
+    for (std::size_t op = 0; op < Calculator::size; ++op) {
+        choiceSource = op;
+        std::size_t choice = choiceSource;
+
+        double tPtr = timeLoop([&] { loopPointer(operations[choice], a.data(), b.data(), out1.data(), N); }, repeats);
+        double tSwitch = timeLoop([&] { loopSwitch(choice, a.data(), b.data(), out2.data(), N); }, repeats);
+        double tTemplate = timeLoop([&] { loopTemplate(choice, a.data(), b.data(), out3.data(), N); }, repeats);
+
+        bool same = (out1 == out2) && (out1 == out3);
+        std::cout << Calculator::names[op] << ": pointer " << tPtr << " s, switch " << tSwitch
+            << " s, template " << tTemplate << " s (x" << tPtr / tTemplate << " vs pointer)"
+            << (same ? "" : "  MISMATCH!") << "\n";
+    }
+
+    std::cout << "\nNote: the pointer loop pays an opaque call per element; the template loop dispatches once\n"
+        << "and the compiler inlines and vectorizes the chosen operation.\n";
+
+    return 0;
+}
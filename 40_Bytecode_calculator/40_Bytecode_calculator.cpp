@@ -0,0 +1,324 @@
+// -----------------------------
+// Demo: compiling calculator formulas to register bytecode
+// -----------------------------
+#include <iostream>
+#include <vector>
+#include <string>
+#include <memory>
+#include <cctype>
+#include <cstdint>
+#include <stdexcept>
+#include <chrono>
+#include <algorithm>
+
+// Same basic arithmetic functions as 03_FunctionPointers_3
+int add(int a, int b) { return a + b; }
+int sub(int a, int b) { return a - b; }
+int mul(int a, int b) { return a * b; }
+int divide(int a, int b) { return b != 0 ? a / b : 0; } // simple check for division
+
+using fPtr = int(*)(int, int);
+
+// -----------------------------
+// Syntax tree: what "a chain of function-pointer calls" looks like today
+// -----------------------------
+struct Node {
+    fPtr op = nullptr;      // nullptr for leaves
+    int value = 0;          // constant leaf
+    int variable = -1;      // variable leaf (index into the inputs)
+    std::unique_ptr<Node> left, right;
+};
+
+// Naive evaluator: recursive walk, one indirect call per operator node
+int evalTree(const Node& n, const int* vars) {
+    if (!n.op) return n.variable >= 0 ? vars[n.variable] : n.value;
+    return n.op(evalTree(*n.left, vars), evalTree(*n.right, vars));
+}
+
+// -----------------------------
+// Parser: expr := term (('+'|'-') term)*, term := factor (('*'|'/') factor)*
+//         factor := number | name | '(' expr ')' | '-' factor
+// -----------------------------
+class Parser {
+public:
+    Parser(const std::string& text, std::vector<std::string>& variables)
+        : src(text), vars(variables) {
+    }
+
+    std::unique_ptr<Node> parse() {
+        auto n = expr();
+        skipSpaces();
+        if (pos != src.size()) throw std::runtime_error("unexpected '" + std::string(1, src[pos]) + "'");
+        return n;
+    }
+
+private:
+    const std::string& src;
+    std::vector<std::string>& vars;
+    std::size_t pos = 0;
+
+    void skipSpaces() {
+        while (pos < src.size() && std::isspace(static_cast<unsigned char>(src[pos]))) ++pos;
+    }
+
+    bool accept(char c) {
+        skipSpaces();
+        if (pos < src.size() && src[pos] == c) { ++pos; return true; }
+        return false;
+    }
+
+    static std::unique_ptr<Node> binary(fPtr op, std::unique_ptr<Node> l, std::unique_ptr<Node> r) {
+        auto n = std::make_unique<Node>();
+        n->op = op;
+        n->left = std::move(l);
+        n->right = std::move(r);
+        return n;
+    }
+
+    std::unique_ptr<Node> expr() {
+        auto n = term();
+        for (;;) {
+            if (accept('+')) n = binary(add, std::move(n), term());
+            else if (accept('-')) n = binary(sub, std::move(n), term());
+            else return n;
+        }
+    }
+
+    std::unique_ptr<Node> term() {
+        auto n = factor();
+        for (;;) {
+            if (accept('*')) n = binary(mul, std::move(n), factor());
+            else if (accept('/')) n = binary(divide, std::move(n), factor());
+            else return n;
+        }
+    }
+
+    std::unique_ptr<Node> factor() {
+        if (accept('(')) {
+            auto n = expr();
+            if (!accept(')')) throw std::runtime_error("expected ')'");
+            return n;
+        }
+        if (accept('-')) {
+            auto zero = std::make_unique<Node>();
+            return binary(sub, std::move(zero), factor());
+        }
+        skipSpaces();
+        auto n = std::make_unique<Node>();
+        if (pos < src.size() && std::isdigit(static_cast<unsigned char>(src[pos]))) {
+            long long v = 0;
+            while (pos < src.size() && std::isdigit(static_cast<unsigned char>(src[pos]))) {
+                v = v * 10 + (src[pos++] - '0');
+                if (v > INT32_MAX) throw std::runtime_error("constant out of range");
+            }
+            n->value = static_cast<int>(v);
+            return n;
+        }
+        if (pos < src.size() && std::isalpha(static_cast<unsigned char>(src[pos]))) {
+            std::size_t start = pos;
+            while (pos < src.size() && std::isalnum(static_cast<unsigned char>(src[pos]))) ++pos;
+            std::string name = src.substr(start, pos - start);
+            std::size_t i = 0;
+            while (i < vars.size() && vars[i] != name) ++i;
+            if (i == vars.size()) vars.push_back(name);
+            n->variable = static_cast<int>(i);
+            return n;
+        }
+        throw std::runtime_error(pos < src.size() ? "unexpected '" + std::string(1, src[pos]) + "'" : "unexpected end of input");
+    }
+};
+
+// -----------------------------
+// Bytecode: 4-byte three-address instructions over a register file
+// -----------------------------
+// Registers [0, numVars) hold the inputs, the next ones hold constants
+// (preloaded once per evaluation), the rest are temporaries.
+enum Opcode : std::uint8_t { OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_RET };
+
+struct Instr {
+    std::uint8_t op, dst, lhs, rhs;
+};
+
+struct Program {
+    std::vector<std::string> variables;
+    std::vector<int> constants;
+    std::vector<Instr> code;
+    std::size_t numRegisters = 0;
+};
+
+class Compiler {
+public:
+    static Program compile(const std::string& text) {
+        Program p;
+        auto tree = Parser(text, p.variables).parse();
+        Compiler c(p);
+        c.collectConstants(*tree);
+        std::uint8_t result = c.emit(*tree, static_cast<unsigned>(p.variables.size() + p.constants.size()));
+        p.code.push_back({ OP_RET, result, 0, 0 });
+        return p;
+    }
+
+private:
+    Program& prog;
+    unsigned constantsSeen = 0;
+
+    explicit Compiler(Program& p) : prog(p) {}
+
+    static std::uint8_t checkReg(unsigned r) {
+        if (r > 255) throw std::runtime_error("expression needs more than 256 registers");
+        return static_cast<std::uint8_t>(r);
+    }
+
+    void collectConstants(const Node& n) {
+        if (n.op) {
+            collectConstants(*n.left);
+            collectConstants(*n.right);
+        }
+        else if (n.variable < 0) {
+            prog.constants.push_back(n.value);
+        }
+    }
+
+    std::uint8_t leafRegister(const Node& n) {
+        if (n.variable >= 0) return checkReg(n.variable);
+        // constants were collected in tree order, so count the ones seen so far
+        return checkReg(static_cast<unsigned>(prog.variables.size() + constantsSeen++));
+    }
+
+    // Emit code for n, using registers from `next` upwards for temporaries.
+    // Leaves cost no instruction: their value already sits in a register.
+    std::uint8_t emit(const Node& n, unsigned next) {
+        if (!n.op) return leafRegister(n);
+        std::uint8_t l = emit(*n.left, next);
+        std::uint8_t r = emit(*n.right, n.left->op ? next + 1 : next);
+        std::uint8_t dst = checkReg(next);
+        if (next + 1 > prog.numRegisters) prog.numRegisters = next + 1;
+        prog.code.push_back({ opcodeFor(n.op), dst, l, r });
+        return dst;
+    }
+
+    static std::uint8_t opcodeFor(fPtr op) {
+        if (op == add) return OP_ADD;
+        if (op == sub) return OP_SUB;
+        if (op == mul) return OP_MUL;
+        return OP_DIV;
+    }
+};
+
+// -----------------------------
+// Interpreter: threaded dispatch with computed goto (GCC/Clang), switch otherwise
+// -----------------------------
+class Interpreter {
+public:
+    explicit Interpreter(const Program& p)
+        : prog(p), regs(std::max(p.numRegisters, p.variables.size() + p.constants.size())) {
+        std::copy(p.constants.begin(), p.constants.end(), regs.begin() + p.variables.size());
+    }
+
+    int run(const int* vars) {
+        int* r = regs.data();
+        for (std::size_t i = 0; i < prog.variables.size(); ++i) r[i] = vars[i];
+        const Instr* ip = prog.code.data();
+
+#if defined(__GNUC__)
+        // Every handler ends with its own indirect jump, so the branch predictor
+        // learns "what follows ADD" separately from "what follows MUL"
+        static void* const labels[] = { &&do_add, &&do_sub, &&do_mul, &&do_div, &&do_ret };
+#define DISPATCH() goto *labels[ip->op]
+        DISPATCH();
+    do_add: r[ip->dst] = r[ip->lhs] + r[ip->rhs]; ++ip; DISPATCH();
+    do_sub: r[ip->dst] = r[ip->lhs] - r[ip->rhs]; ++ip; DISPATCH();
+    do_mul: r[ip->dst] = r[ip->lhs] * r[ip->rhs]; ++ip; DISPATCH();
+    do_div: {
+            int b = r[ip->rhs];
+            r[ip->dst] = b != 0 ? r[ip->lhs] / b : 0;
+            ++ip;
+            DISPATCH();
+        }
+    do_ret: return r[ip->dst];
+#undef DISPATCH
+#else
+        for (;; ++ip) {
+            switch (ip->op) {
+            case OP_ADD: r[ip->dst] = r[ip->lhs] + r[ip->rhs]; break;
+            case OP_SUB: r[ip->dst] = r[ip->lhs] - r[ip->rhs]; break;
+            case OP_MUL: r[ip->dst] = r[ip->lhs] * r[ip->rhs]; break;
+            case OP_DIV: {
+                int b = r[ip->rhs];
+                r[ip->dst] = b != 0 ? r[ip->lhs] / b : 0;
+                break;
+            }
+            default: return r[ip->dst];
+            }
+        }
+#endif
+    }
+
+private:
+    const Program& prog;
+    std::vector<int> regs;
+};
+
+void disassemble(const Program& p) {
+    const char* names[] = { "add", "sub", "mul", "div", "ret" };
+    for (std::size_t i = 0; i < p.variables.size(); ++i)
+        std::cout << "  r" << i << " = " << p.variables[i] << "\n";
+    for (std::size_t i = 0; i < p.constants.size(); ++i)
+        std::cout << "  r" << p.variables.size() + i << " = " << p.constants[i] << "\n";
+    for (const Instr& in : p.code) {
+        if (in.op == OP_RET) std::cout << "  ret r" << int(in.dst) << "\n";
+        else std::cout << "  " << names[in.op] << " r" << int(in.dst) << ", r" << int(in.lhs) << ", r" << int(in.rhs) << "\n";
+    }
+}
+
+int main() {
+    const std::string formula = "(x + 3) * (y - 2) / (x - y + 1) + x * 7 - (y * y) / 5";
+
+    std::cout << "=== Compiling: " << formula << " ===\n";
+    Program prog = Compiler::compile(formula);
+    disassemble(prog);
+    std::cout << "Instructions: " << prog.code.size() << " x " << sizeof(Instr) << " bytes\n";
+
+    std::vector<std::string> treeVars;
+    auto tree = Parser(formula, treeVars).parse();
+    Interpreter interp(prog);
+
+    int sample[] = { 10, 4 };
+    std::cout << "x=10, y=4 -> tree walk: " << evalTree(*tree, sample)
+        << ", bytecode: " << interp.run(sample) << "\n";
+
+    std::cout << "\n=== Parse errors are reported, not evaluated ===\n";
+    try {
+        Compiler::compile("x + * 2");
+    }
+    catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << "\n";
+    }
+
+    // Benchmark: many evaluations of the same formula with changing inputs
+    const int evaluations = 10'000'000;
+    long long sumTree = 0, sumByte = 0;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < evaluations; ++i) {
+        int vars[] = { i & 1023, (i >> 3) & 511 };
+        sumTree += evalTree(*tree, vars);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> tTree = end - start;
+
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < evaluations; ++i) {
+        int vars[] = { i & 1023, (i >> 3) & 511 };
+        sumByte += interp.run(vars);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> tByte = end - start;
+
+    std::cout << "\n=== " << evaluations << " evaluations ===\n";
+    std::cout << "Pointer tree walk: " << tTree.count() << " s (" << evaluations / tTree.count() / 1e6 << " M evals/s)\n";
+    std::cout << "Bytecode:          " << tByte.count() << " s (" << evaluations / tByte.count() / 1e6 << " M evals/s)\n";
+    std::cout << "Checksums " << (sumTree == sumByte ? "match" : "DIFFER") << ": " << sumTree << "\n";
+
+    return 0;
+}
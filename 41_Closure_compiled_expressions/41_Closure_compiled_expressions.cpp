@@ -0,0 +1,308 @@
+// -----------------------------
+// Demo: compiling member-pointer expression trees into specialized closures
+// -----------------------------
+#include <iostream>
+#include <vector>
+#include <utility>
+#include <memory>
+#include <random>
+#include <chrono>
+#include <stdexcept>
+
+class Calculator
+{
+public:
+    // Same methods as 04_FunctionPointers_4. They wrap around instead of
+    // overflowing, because deep random trees easily leave the int range.
+    int add(int a, int b)
+    {
+        return static_cast<int>(static_cast<unsigned>(a) + static_cast<unsigned>(b));
+    }
+
+    int sub(int a, int b)
+    {
+        return static_cast<int>(static_cast<unsigned>(a) - static_cast<unsigned>(b));
+    }
+
+    int mul(int a, int b)
+    {
+        return static_cast<int>(static_cast<unsigned>(a) * static_cast<unsigned>(b));
+    }
+};
+
+using MethodPtr = int(Calculator::*)(int, int);
+
+// -----------------------------
+// Expression tree, as it is built from user input
+// -----------------------------
+struct Expr
+{
+    enum Kind { Const, Var, Call } kind = Const;
+    int value = 0;              // Const: the constant, Var: the input index
+    MethodPtr method = nullptr; // Call only
+    std::unique_ptr<Expr> left, right;
+};
+
+// Naive evaluator: recursion plus (calc.*ptr) on every node
+int evalNaive(Calculator& calc, const Expr& e, const int* vars)
+{
+    switch (e.kind) {
+    case Expr::Const: return e.value;
+    case Expr::Var: return vars[e.value];
+    default: return (calc.*e.method)(evalNaive(calc, *e.left, vars), evalNaive(calc, *e.right, vars));
+    }
+}
+
+// -----------------------------
+// Compiled form: one closure per call node
+// -----------------------------
+// Each closure is a plain function pointer plus its operands. The function is
+// a template instantiation for <method, left kind, right kind>: the member
+// pointer is a template argument, so (calc.*M)(l, r) is a direct, inlinable
+// call, and constant/variable operands are read inline instead of recursing.
+struct Closure
+{
+    using Fn = int(*)(const Closure&, Calculator&, const int*);
+    Fn fn = nullptr;
+    int lhs = 0, rhs = 0;                 // constant value or input index
+    const Closure* lhsNode = nullptr;
+    const Closure* rhsNode = nullptr;
+
+    int operator()(Calculator& calc, const int* vars) const { return fn(*this, calc, vars); }
+};
+
+enum class Operand { Const, Var, Node };
+
+template <Operand K>
+inline int fetch(int slot, const Closure* node, Calculator& calc, const int* vars)
+{
+    if constexpr (K == Operand::Const) return slot;
+    else if constexpr (K == Operand::Var) return vars[slot];
+    else return node->fn(*node, calc, vars);
+}
+
+template <MethodPtr M, Operand L, Operand R>
+int invokeClosure(const Closure& c, Calculator& calc, const int* vars)
+{
+    int l = fetch<L>(c.lhs, c.lhsNode, calc, vars);
+    int r = fetch<R>(c.rhs, c.rhsNode, calc, vars);
+    return (calc.*M)(l, r);
+}
+
+template <MethodPtr M, Operand L>
+Closure::Fn pickRight(Operand r)
+{
+    switch (r) {
+    case Operand::Const: return &invokeClosure<M, L, Operand::Const>;
+    case Operand::Var: return &invokeClosure<M, L, Operand::Var>;
+    default: return &invokeClosure<M, L, Operand::Node>;
+    }
+}
+
+template <MethodPtr M>
+Closure::Fn pickLeft(Operand l, Operand r)
+{
+    switch (l) {
+    case Operand::Const: return pickRight<M, Operand::Const>(r);
+    case Operand::Var: return pickRight<M, Operand::Var>(r);
+    default: return pickRight<M, Operand::Node>(r);
+    }
+}
+
+// The only place member pointers are compared: once per node, at build time
+Closure::Fn pickClosure(MethodPtr m, Operand l, Operand r)
+{
+    if (m == &Calculator::add) return pickLeft<&Calculator::add>(l, r);
+    if (m == &Calculator::sub) return pickLeft<&Calculator::sub>(l, r);
+    if (m == &Calculator::mul) return pickLeft<&Calculator::mul>(l, r);
+    throw std::invalid_argument("unknown Calculator method");
+}
+
+class CompiledExpr
+{
+public:
+    CompiledExpr(Calculator& calc, const Expr& e)
+    {
+        nodes.reserve(countCalls(e)); // closures point at each other: no reallocation allowed
+        Operand kind;
+        int slot;
+        const Closure* node = build(calc, e, kind, slot);
+        if (kind == Operand::Node) {
+            root = node;
+        }
+        else {
+            rootValue = slot;
+            rootIsVar = (kind == Operand::Var);
+        }
+    }
+
+    // Closures point into `nodes`: a copy would point into the source's
+    // storage. Moving keeps the vector's buffer, so the pointers stay valid.
+    CompiledExpr(const CompiledExpr&) = delete;
+    CompiledExpr& operator=(const CompiledExpr&) = delete;
+
+    CompiledExpr(CompiledExpr&& other) noexcept
+        : nodes(std::move(other.nodes)), root(std::exchange(other.root, nullptr)),
+          rootValue(other.rootValue), rootIsVar(other.rootIsVar)
+    {
+    }
+
+    CompiledExpr& operator=(CompiledExpr&& other) noexcept
+    {
+        if (this != &other) {
+            nodes = std::move(other.nodes);
+            root = std::exchange(other.root, nullptr);
+            rootValue = other.rootValue;
+            rootIsVar = other.rootIsVar;
+        }
+        return *this;
+    }
+
+    int operator()(Calculator& calc, const int* vars) const
+    {
+        if (root) return (*root)(calc, vars);
+        return rootIsVar ? vars[rootValue] : rootValue;
+    }
+
+    std::size_t size() const { return nodes.size(); }
+
+private:
+    std::vector<Closure> nodes; // post-order: each closure sits right after its subtrees
+    const Closure* root = nullptr;
+    int rootValue = 0;
+    bool rootIsVar = false;
+
+    static std::size_t countCalls(const Expr& e)
+    {
+        return e.kind == Expr::Call ? 1 + countCalls(*e.left) + countCalls(*e.right) : 0;
+    }
+
+    const Closure* build(Calculator& calc, const Expr& e, Operand& kind, int& slot)
+    {
+        if (e.kind != Expr::Call) {
+            kind = e.kind == Expr::Const ? Operand::Const : Operand::Var;
+            slot = e.value;
+            return nullptr;
+        }
+
+        Operand lk, rk;
+        int ls = 0, rs = 0;
+        const Closure* ln = build(calc, *e.left, lk, ls);
+        const Closure* rn = build(calc, *e.right, rk, rs);
+
+        // Both operands known: fold the call now, the node becomes a constant
+        if (lk == Operand::Const && rk == Operand::Const) {
+            kind = Operand::Const;
+            slot = (calc.*e.method)(ls, rs);
+            return nullptr;
+        }
+
+        Closure c;
+        c.fn = pickClosure(e.method, lk, rk);
+        c.lhs = ls;
+        c.rhs = rs;
+        c.lhsNode = ln;
+        c.rhsNode = rn;
+        nodes.push_back(c);
+        kind = Operand::Node;
+        return &nodes.back();
+    }
+};
+
+// -----------------------------
+// Random deep trees for the benchmark
+// -----------------------------
+std::unique_ptr<Expr> randomTree(std::mt19937& rng, int depth, int numVars)
+{
+    auto e = std::make_unique<Expr>();
+    std::uniform_int_distribution<int> pick(0, 9);
+    if (depth == 0 || pick(rng) == 0) {
+        if (pick(rng) < 4) {
+            e->kind = Expr::Const;
+            e->value = pick(rng) - 3;
+        }
+        else {
+            e->kind = Expr::Var;
+            e->value = pick(rng) % numVars;
+        }
+        return e;
+    }
+    MethodPtr methods[] = { &Calculator::add, &Calculator::sub, &Calculator::mul };
+    e->kind = Expr::Call;
+    e->method = methods[pick(rng) % 3];
+    e->left = randomTree(rng, depth - 1, numVars);
+    e->right = randomTree(rng, depth - 1, numVars);
+    return e;
+}
+
+std::unique_ptr<Expr> leaf(Expr::Kind kind, int value)
+{
+    auto e = std::make_unique<Expr>();
+    e->kind = kind;
+    e->value = value;
+    return e;
+}
+
+std::unique_ptr<Expr> call(MethodPtr m, std::unique_ptr<Expr> l, std::unique_ptr<Expr> r)
+{
+    auto e = std::make_unique<Expr>();
+    e->kind = Expr::Call;
+    e->method = m;
+    e->left = std::move(l);
+    e->right = std::move(r);
+    return e;
+}
+
+int main()
+{
+    Calculator calc;
+
+    std::cout << "=== Small tree: mul(add(x, 5), sub(y, add(2, 3))) ===\n";
+    auto small = call(&Calculator::mul,
+        call(&Calculator::add, leaf(Expr::Var, 0), leaf(Expr::Const, 5)),
+        call(&Calculator::sub, leaf(Expr::Var, 1), call(&Calculator::add, leaf(Expr::Const, 2), leaf(Expr::Const, 3))));
+    CompiledExpr smallCompiled(calc, *small);
+    int xy[] = { 10, 7 };
+    std::cout << "naive: " << evalNaive(calc, *small, xy) << ", compiled: " << smallCompiled(calc, xy)
+        << " (" << smallCompiled.size() << " closures, add(2, 3) folded at build time)\n";
+    std::vector<CompiledExpr> programs;
+    for (int i = 0; i < 8; ++i) programs.emplace_back(calc, *small); // reallocations move the earlier ones
+    std::cout << "first of " << programs.size() << " after the vector grew: " << programs.front()(calc, xy) << "\n";
+
+    std::cout << "\n=== Deep random tree ===\n";
+    const int numVars = 4;
+    std::mt19937 rng(2024);
+    auto tree = randomTree(rng, 16, numVars);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    CompiledExpr compiled(calc, *tree);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> buildTime = end - start;
+    std::cout << "Compiled " << compiled.size() << " closures in " << buildTime.count() << " s\n";
+
+    const int evaluations = 2000;
+    long long sumNaive = 0, sumCompiled = 0;
+
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < evaluations; ++i) {
+        int vars[numVars] = { i, i + 1, i * 3, -i };
+        sumNaive += evalNaive(calc, *tree, vars);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> naiveTime = end - start;
+
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < evaluations; ++i) {
+        int vars[numVars] = { i, i + 1, i * 3, -i };
+        sumCompiled += compiled(calc, vars);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> compiledTime = end - start;
+
+    std::cout << "Naive (calc.*ptr) evaluator: " << naiveTime.count() << " s\n";
+    std::cout << "Compiled closures:           " << compiledTime.count() << " s (x"
+        << naiveTime.count() / compiledTime.count() << ")\n";
+    std::cout << "Checksums " << (sumNaive == sumCompiled ? "match" : "DIFFER") << "\n";
+
+    return 0;
+}
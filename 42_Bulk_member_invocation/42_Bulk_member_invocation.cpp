@@ -0,0 +1,172 @@
+// -----------------------------
+// Demo: applying one member function pointer to a whole array of objects
+// -----------------------------
+#include <iostream>
+#include <vector>
+#include <span>
+#include <utility>
+#include <thread>
+#include <algorithm>
+#include <stdexcept>
+#include <chrono>
+
+class Calculator
+{
+private:
+    int calls = 0; // a little per-object state, so every object really is touched
+
+public:
+    int add(int a, int b)
+    {
+        ++calls;
+        return a + b;
+    }
+
+    int sub(int a, int b)
+    {
+        ++calls;
+        return a - b;
+    }
+
+    int mul(int a, int b)
+    {
+        ++calls;
+        return a * b;
+    }
+
+    int getCalls() const { return calls; }
+};
+
+using MethodPtr = int(Calculator::*)(int, int);
+using Operands = std::pair<int, int>;
+
+// -----------------------------
+// Resolving the member pointer once
+// -----------------------------
+// A loop over objects[i].*ptr still calls through the pointer on every element.
+// Matching the pointer against the known methods once picks a loop where the
+// method is a template argument: the call is direct and inlined into the loop.
+using LoopFn = void(*)(Calculator*, const Operands*, int*, std::size_t, MethodPtr);
+
+template <MethodPtr M>
+void invokeLoop(Calculator* objects, const Operands* args, int* out, std::size_t n, MethodPtr)
+{
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = (objects[i].*M)(args[i].first, args[i].second);
+    }
+}
+
+// Fallback for pointers we do not know about: still one tight loop
+void invokeLoopGeneric(Calculator* objects, const Operands* args, int* out, std::size_t n, MethodPtr m)
+{
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = (objects[i].*m)(args[i].first, args[i].second);
+    }
+}
+
+LoopFn resolve(MethodPtr m)
+{
+    if (m == &Calculator::add) return &invokeLoop<&Calculator::add>;
+    if (m == &Calculator::sub) return &invokeLoop<&Calculator::sub>;
+    if (m == &Calculator::mul) return &invokeLoop<&Calculator::mul>;
+    return &invokeLoopGeneric;
+}
+
+void checkSizes(std::span<Calculator> objects, std::span<const Operands> args, std::span<int> out)
+{
+    if (args.size() != objects.size() || out.size() != objects.size()) {
+        throw std::invalid_argument("invoke_all: objects, args and out must have the same size");
+    }
+}
+
+// out[i] = (objects[i].*m)(args[i].first, args[i].second)
+void invoke_all(std::span<Calculator> objects, MethodPtr m, std::span<const Operands> args, std::span<int> out)
+{
+    checkSizes(objects, args, out);
+    resolve(m)(objects.data(), args.data(), out.data(), objects.size(), m);
+}
+
+std::vector<int> invoke_all(std::span<Calculator> objects, MethodPtr m, std::span<const Operands> args)
+{
+    std::vector<int> out(objects.size());
+    invoke_all(objects, m, args, out);
+    return out;
+}
+
+// Same contract, with the range split into one contiguous chunk per thread.
+// Chunk sizes are rounded up to a cache line's worth of objects. When the
+// objects start on a 64-byte boundary, two threads never write to the same line
+// of Calculator state; otherwise they can share at most the line at each boundary.
+void invoke_all_parallel(std::span<Calculator> objects, MethodPtr m, std::span<const Operands> args,
+    std::span<int> out, unsigned threads = std::thread::hardware_concurrency())
+{
+    checkSizes(objects, args, out);
+    LoopFn loop = resolve(m);
+
+    const std::size_t n = objects.size();
+    const std::size_t perLine = std::max<std::size_t>(1, 64 / sizeof(Calculator));
+    threads = std::max(1u, threads);
+    std::size_t chunk = (n + threads - 1) / threads;
+    chunk = (chunk + perLine - 1) / perLine * perLine;
+
+    std::vector<std::thread> workers;
+    for (std::size_t begin = chunk; begin < n; begin += chunk) {
+        std::size_t count = std::min(chunk, n - begin);
+        workers.emplace_back(loop, objects.data() + begin, args.data() + begin, out.data() + begin, count, m);
+    }
+    loop(objects.data(), args.data(), out.data(), std::min(chunk, n), m); // first chunk on the calling thread
+    for (auto& w : workers) w.join();
+}
+
+int main()
+{
+    std::cout << "=== invoke_all on a small fleet ===\n";
+    std::vector<Calculator> small(4);
+    std::vector<Operands> smallArgs = { {10, 5}, {3, 4}, {7, 7}, {-2, 9} };
+    std::vector<int> smallOut = invoke_all(small, &Calculator::mul, smallArgs);
+    for (std::size_t i = 0; i < small.size(); ++i) {
+        std::cout << "calc[" << i << "].mul(" << smallArgs[i].first << ", " << smallArgs[i].second
+            << ") = " << smallOut[i] << "\n";
+    }
+
+    const std::size_t N = 4'000'000;
+    const int repeats = 10;
+    std::vector<Calculator> fleet(N);
+    std::vector<Operands> args(N);
+    for (std::size_t i = 0; i < N; ++i) args[i] = { static_cast<int>(i % 1000), static_cast<int>(i % 7) };
+    std::vector<int> expected(N), out(N), outParallel(N);
+
+    // volatile keeps the member pointer a runtime value
+    MethodPtr volatile chosen = &Calculator::sub;
+    MethodPtr ptr = chosen;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < repeats; ++r) {
+        for (std::size_t i = 0; i < N; ++i) {
+            expected[i] = (fleet[i].*ptr)(args[i].first, args[i].second);
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> perObject = end - start;
+
+    start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < repeats; ++r) invoke_all(fleet, ptr, args, out);
+    end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> bulk = end - start;
+
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < repeats; ++r) invoke_all_parallel(fleet, ptr, args, outParallel, threads);
+    end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> parallel = end - start;
+
+    std::cout << "\n=== " << N << " objects x " << repeats << " repeats ===\n";
+    std::cout << "(obj.*ptr) per object:     " << perObject.count() << " s\n";
+    std::cout << "invoke_all:                " << bulk.count() << " s (x" << perObject.count() / bulk.count() << ")\n";
+    std::cout << "invoke_all_parallel (" << threads << "t): " << parallel.count() << " s (x"
+        << perObject.count() / parallel.count() << ")\n";
+    std::cout << "Results " << (expected == out && expected == outParallel ? "match" : "DIFFER")
+        << ", calls on fleet[0] = " << fleet[0].getCalls() << "\n";
+
+    return 0;
+}
@@ -0,0 +1,348 @@
+// -----------------------------
+// Demo: the 03_FunctionPointers_3 calculator fed from a memory-mapped file
+// -----------------------------
+// Usage:
+//   43_Calculator_streaming_io                          interactive, as in 03
+//   43_Calculator_streaming_io --text  in.txt [out.txt] lines of "a b choice"
+//   43_Calculator_streaming_io --binary in.bin [out.txt] int32 triples a, b, choice
+//   43_Calculator_streaming_io --generate-text  N file
+//   43_Calculator_streaming_io --generate-binary N file
+#include <iostream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <chrono>
+#include <random>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Define basic arithmetic functions. Input lines are arbitrary, so results
+// may not fit in an int (signed overflow is UB, and INT_MIN / -1 traps on
+// x86): each is computed exactly in 64 bits and converted back modulo 2^32.
+int wrap(long long v) { return static_cast<int>(v); }
+
+int add(int a, int b) { return wrap(static_cast<long long>(a) + b); }
+int sub(int a, int b) { return wrap(static_cast<long long>(a) - b); }
+int mul(int a, int b) { return wrap(static_cast<long long>(a) * b); }
+int divide(int a, int b) { return b != 0 ? wrap(static_cast<long long>(a) / b) : 0; } // simple check for division
+
+using fPtr = int(*)(int, int);
+fPtr operations[] = { add, sub, mul, divide };
+const char* names[] = { "add", "sub", "mul", "divide" };
+
+// -----------------------------
+// Read-only memory mapping of a whole file
+// -----------------------------
+class MappedFile {
+public:
+    explicit MappedFile(const char* path) {
+        try {
+            open(path);
+        }
+        catch (...) {
+            release(); // the destructor will not run
+            throw;
+        }
+    }
+
+    ~MappedFile() { release(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return ptr; }
+    std::size_t size() const { return length; }
+
+private:
+    void open(const char* path) {
+#if defined(_WIN32)
+        file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) throw std::runtime_error(std::string("cannot open ") + path);
+        LARGE_INTEGER sz;
+        if (!GetFileSizeEx(file, &sz)) throw std::runtime_error(std::string("cannot stat ") + path);
+        length = static_cast<std::size_t>(sz.QuadPart);
+        if (length == 0) return;
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) throw std::runtime_error(std::string("cannot map ") + path);
+        ptr = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+        fd = ::open(path, O_RDONLY);
+        if (fd < 0) throw std::runtime_error(std::string("cannot open ") + path);
+        struct stat st;
+        if (fstat(fd, &st) != 0) throw std::runtime_error(std::string("cannot stat ") + path);
+        length = static_cast<std::size_t>(st.st_size);
+        if (length == 0) return; // mmap refuses empty mappings
+        void* p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) throw std::runtime_error(std::string("cannot map ") + path);
+        madvise(p, length, MADV_SEQUENTIAL); // let the kernel read ahead aggressively
+        ptr = static_cast<const char*>(p);
+#endif
+        if (!ptr) throw std::runtime_error(std::string("cannot map ") + path);
+    }
+
+    void release() {
+#if defined(_WIN32)
+        if (ptr) UnmapViewOfFile(ptr);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+        if (ptr) munmap(const_cast<char*>(ptr), length);
+        if (fd >= 0) close(fd);
+#endif
+        ptr = nullptr;
+#if defined(_WIN32)
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        fd = -1;
+#endif
+    }
+
+    const char* ptr = nullptr;
+    std::size_t length = 0;
+#if defined(_WIN32)
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+};
+
+// -----------------------------
+// Large buffered writer using to_chars (no locale, no iostream state)
+// -----------------------------
+class BufferedWriter {
+public:
+    explicit BufferedWriter(std::FILE* f, std::size_t capacity = 1 << 20) : out(f), buffer(capacity) {}
+
+    // Best effort only: call flush() to find out whether the data was written
+    ~BufferedWriter() {
+        try {
+            flush();
+        }
+        catch (const std::exception&) {
+        }
+    }
+
+    BufferedWriter(const BufferedWriter&) = delete;
+    BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+    void writeInt(int value) {
+        reserve(16); // enough for "-2147483648"
+        auto res = std::to_chars(buffer.data() + used, buffer.data() + buffer.size(), value);
+        used = static_cast<std::size_t>(res.ptr - buffer.data());
+    }
+
+    void write(std::string_view s) {
+        if (s.size() > buffer.size()) {
+            flush();
+            writeAll(s.data(), s.size());
+            return;
+        }
+        reserve(s.size());
+        std::memcpy(buffer.data() + used, s.data(), s.size());
+        used += s.size();
+    }
+
+    void put(char c) {
+        reserve(1);
+        buffer[used++] = c;
+    }
+
+    // Throws std::runtime_error on a short write (disk full, I/O error, ...)
+    void flush() {
+        std::size_t n = std::exchange(used, 0);
+        if (n) writeAll(buffer.data(), n);
+    }
+
+private:
+    std::FILE* out;
+    std::vector<char> buffer;
+    std::size_t used = 0;
+
+    void reserve(std::size_t n) {
+        if (used + n > buffer.size()) flush();
+    }
+
+    void writeAll(const char* data, std::size_t n) {
+        if (std::fwrite(data, 1, n, out) != n) throw std::runtime_error("write failed");
+    }
+};
+
+void writeResult(BufferedWriter& w, int a, int b, int choice) {
+    if (choice >= 0 && choice < 4) w.writeInt(operations[choice](a, b));
+    else w.write("invalid");
+    w.put('\n');
+}
+
+// -----------------------------
+// Text input: whitespace separated "a b choice" triples, parsed with from_chars
+// -----------------------------
+std::size_t runText(const MappedFile& in, BufferedWriter& w) {
+    const char* p = in.data();
+    const char* end = p + in.size();
+    std::size_t count = 0;
+
+    auto skipSpaces = [&] {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) ++p;
+    };
+    auto readInt = [&](int& v) {
+        skipSpaces();
+        auto res = std::from_chars(p, end, v);
+        if (res.ec != std::errc()) {
+            throw std::runtime_error("bad number at byte " + std::to_string(p - in.data()));
+        }
+        p = res.ptr;
+    };
+
+    skipSpaces();
+    while (p < end) {
+        int a, b, choice;
+        readInt(a);
+        readInt(b);
+        readInt(choice);
+        writeResult(w, a, b, choice);
+        ++count;
+        skipSpaces();
+    }
+    return count;
+}
+
+// -----------------------------
+// Binary input: native-endian int32 triples, 12 bytes each
+// -----------------------------
+std::size_t runBinary(const MappedFile& in, BufferedWriter& w) {
+    if (in.size() % (3 * sizeof(std::int32_t)) != 0) {
+        throw std::runtime_error("binary input size is not a multiple of 12 bytes");
+    }
+    std::size_t count = in.size() / (3 * sizeof(std::int32_t));
+    const char* p = in.data();
+    for (std::size_t i = 0; i < count; ++i, p += 3 * sizeof(std::int32_t)) {
+        std::int32_t t[3];
+        std::memcpy(t, p, sizeof(t)); // the mapping gives no alignment guarantee for our purposes
+        writeResult(w, t[0], t[1], t[2]);
+    }
+    return count;
+}
+
+// Closes the output file (or flushes stdout). close() throws if anything
+// failed to reach the file; the destructor quietly cleans up after errors.
+struct OutputFile {
+    std::FILE* f;
+
+    void close() {
+        std::FILE* file = std::exchange(f, nullptr);
+        if (!file) return;
+        bool ok = file == stdout ? std::fflush(file) == 0 && !std::ferror(file) : std::fclose(file) == 0;
+        if (!ok) throw std::runtime_error("cannot finish writing the output");
+    }
+
+    ~OutputFile() {
+        if (f == stdout) std::fflush(f);
+        else if (f) std::fclose(f);
+    }
+};
+
+void generate(bool binary, std::size_t n, const char* path) {
+    OutputFile out{ std::fopen(path, binary ? "wb" : "w") };
+    if (!out.f) throw std::runtime_error(std::string("cannot create ") + path);
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> value(-100000, 100000), op(0, 3);
+    {
+        BufferedWriter w(out.f);
+        for (std::size_t i = 0; i < n; ++i) {
+            std::int32_t t[3] = { value(rng), value(rng) % 100, op(rng) };
+            if (binary) {
+                w.write(std::string_view(reinterpret_cast<const char*>(t), sizeof(t)));
+            }
+            else {
+                w.writeInt(t[0]); w.put(' ');
+                w.writeInt(t[1]); w.put(' ');
+                w.writeInt(t[2]); w.put('\n');
+            }
+        }
+        w.flush();
+    }
+    out.close();
+}
+
+int interactive() {
+    int a, b, choice;
+
+    std::cout << "Enter two integers: ";
+    std::cin >> a >> b;
+
+    std::cout << "\nSelect an operation:\n";
+    for (int i = 0; i < 4; ++i)
+    {
+        std::cout << i << " - " << names[i] << "\n";
+    }
+
+    std::cout << "Your choice: (0, 1, 2, 3)";
+    std::cin >> choice;
+
+    if (choice >= 0 && choice < 4)
+    {
+        int result = operations[choice](a, b);
+        std::cout << "Result of " << names[choice] << "(" << a << ", " << b << "): " << result << "\n";
+    }
+    else
+    {
+        std::cout << "Invalid choice!\n";
+    }
+
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) return interactive();
+
+    std::string mode = argv[1];
+    try {
+        if ((mode == "--generate-text" || mode == "--generate-binary") && argc == 4) {
+            generate(mode == "--generate-binary", std::stoull(argv[2]), argv[3]);
+            return 0;
+        }
+        if ((mode == "--text" || mode == "--binary") && (argc == 3 || argc == 4)) {
+            MappedFile in(argv[2]);
+            OutputFile outFile{ argc == 4 ? std::fopen(argv[3], "wb") : stdout };
+            if (!outFile.f) throw std::runtime_error(std::string("cannot create ") + argv[3]);
+
+            auto start = std::chrono::high_resolution_clock::now();
+            std::size_t count;
+            {
+                BufferedWriter w(outFile.f); // flushes what it holds even if a later line is bad
+                count = mode == "--text" ? runText(in, w) : runBinary(in, w);
+                w.flush();
+            }
+            outFile.close();
+            auto end = std::chrono::high_resolution_clock::now();
+            std::chrono::duration<double> elapsed = end - start;
+
+            std::cerr << count << " triples (" << in.size() / (1024.0 * 1024.0) << " MB) in "
+                << elapsed.count() << " s, " << in.size() / (1024.0 * 1024.0) / elapsed.count() << " MB/s\n";
+            return 0;
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    std::cerr << "Usage: " << argv[0] << " [--text|--binary input [output]] [--generate-text|--generate-binary N file]\n";
+    return 1;
+}
@@ -0,0 +1,282 @@
+// -----------------------------
+// Benchmark: per-call cost of the callables seen in 02-11
+// -----------------------------
+// Every row calls a callable that computes x * 3 + 1 on N inputs and reports
+// ns/call, and on Linux also instructions/call and the branch-miss rate read
+// from hardware counters (perf_event_open; shown as n/a when not permitted).
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <functional>
+#include <random>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(_MSC_VER)
+#define NOINLINE __declspec(noinline)
+#else
+#define NOINLINE __attribute__((noinline))
+#endif
+
+// -----------------------------
+// Hardware counters
+// -----------------------------
+class PerfCounter {
+public:
+    enum Event { Instructions, Branches, BranchMisses, Count };
+
+    PerfCounter() {
+#if defined(__linux__)
+        const std::uint64_t configs[Count] = {
+            PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_BRANCH_INSTRUCTIONS, PERF_COUNT_HW_BRANCH_MISSES };
+        for (int i = 0; i < Count; ++i) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[i];
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+#endif
+    }
+
+    ~PerfCounter() {
+#if defined(__linux__)
+        for (int fd : fds) if (fd >= 0) close(fd);
+#endif
+    }
+
+    bool available(Event e) const { return fds[e] >= 0; }
+
+    void start() {
+#if defined(__linux__)
+        for (int fd : fds) {
+            if (fd < 0) continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    void stop() {
+#if defined(__linux__)
+        for (int i = 0; i < Count; ++i) {
+            if (fds[i] < 0) continue;
+            ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+            std::uint64_t v = 0;
+            if (read(fds[i], &v, sizeof(v)) != sizeof(v)) v = 0;
+            values[i] = v;
+        }
+#endif
+    }
+
+    std::uint64_t value(Event e) const { return values[e]; }
+
+private:
+    int fds[Count] = { -1, -1, -1 };
+    std::uint64_t values[Count] = {};
+};
+
+// -----------------------------
+// The callables
+// -----------------------------
+int work(int x) { return x * 3 + 1; }
+int workB(int x) { return x * 5 - 2; }
+int workC(int x) { return x ^ 0x5a5a; }
+int workD(int x) { return x + 77; }
+
+int workTwo(int x, int y) { return x * y + 1; }
+
+struct Worker {
+    int factor = 3;
+    int process(int x) const { return x * factor + 1; }
+};
+
+struct WorkFunctor {
+    int factor = 3;
+    int operator()(int x) const { return x * factor + 1; }
+};
+
+using fPtr = int(*)(int);
+using MethodPtr = int(Worker::*)(int) const;
+
+// Written by every loop: a side effect the optimizer cannot hoist out of the repeats
+volatile long long sink = 0;
+
+// A function pointer moved into the type: the target is a compile-time constant
+template <fPtr F>
+struct FixedTarget {
+    int operator()(int x) const { return F(x); }
+};
+
+// The callable's type is a template parameter: whatever the compiler can see
+// through (functors, lambdas, bind objects) it inlines into the loop.
+template <typename F>
+NOINLINE long long callLoop(F& f, const int* in, std::size_t n) {
+    long long sum = 0;
+    for (std::size_t i = 0; i < n; ++i) sum += f(in[i]);
+    sink = sum;
+    return sum;
+}
+
+NOINLINE long long memberLoop(const Worker& w, MethodPtr m, const int* in, std::size_t n) {
+    long long sum = 0;
+    for (std::size_t i = 0; i < n; ++i) sum += (w.*m)(in[i]);
+    sink = sum;
+    return sum;
+}
+
+// A different target on every element: stresses the indirect branch predictor
+NOINLINE long long mixedPointerLoop(const fPtr* targets, const int* in, std::size_t n) {
+    long long sum = 0;
+    for (std::size_t i = 0; i < n; ++i) sum += targets[i](in[i]);
+    sink = sum;
+    return sum;
+}
+
+NOINLINE long long mixedFunctionLoop(const std::vector<std::function<int(int)>>& targets, const int* in, std::size_t n) {
+    long long sum = 0;
+    for (std::size_t i = 0; i < n; ++i) sum += targets[i](in[i]);
+    sink = sum;
+    return sum;
+}
+
+// Hide a value from the optimizer, so "opaque" rows really call through memory
+template <typename T>
+T launder(T value) {
+    volatile T v = value;
+    return v;
+}
+
+// -----------------------------
+// Harness
+// -----------------------------
+struct Row {
+    std::string name;
+    double nsPerCall;
+    double instrPerCall;
+    double missRate;
+    long long checksum;
+};
+
+template <typename Body>
+Row measure(const std::string& name, std::size_t calls, int repeats, Body body) {
+    PerfCounter perf;
+    body(); // warm up caches and predictors
+
+    long long checksum = 0;
+    perf.start();
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < repeats; ++r) checksum += body();
+    auto end = std::chrono::high_resolution_clock::now();
+    perf.stop();
+
+    double total = static_cast<double>(calls) * repeats;
+    std::chrono::duration<double, std::nano> elapsed = end - start;
+    Row row{ name, elapsed.count() / total, -1.0, -1.0, checksum };
+    if (perf.available(PerfCounter::Instructions)) {
+        row.instrPerCall = perf.value(PerfCounter::Instructions) / total;
+    }
+    if (perf.available(PerfCounter::Branches) && perf.available(PerfCounter::BranchMisses) && perf.value(PerfCounter::Branches)) {
+        row.missRate = 100.0 * perf.value(PerfCounter::BranchMisses) / perf.value(PerfCounter::Branches);
+    }
+    return row;
+}
+
+void print(const Row& r) {
+    std::cout << std::left << std::setw(40) << r.name << std::right << std::fixed
+        << std::setw(10) << std::setprecision(3) << r.nsPerCall;
+    if (r.instrPerCall >= 0) std::cout << std::setw(12) << std::setprecision(2) << r.instrPerCall;
+    else std::cout << std::setw(12) << "n/a";
+    if (r.missRate >= 0) std::cout << std::setw(11) << std::setprecision(2) << r.missRate << "%";
+    else std::cout << std::setw(12) << "n/a";
+    std::cout << "\n";
+}
+
+int main() {
+    const std::size_t N = 1 << 16; // fits in L1/L2: we measure calls, not memory
+    const int repeats = 400;
+
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> dist(0, 1 << 20);
+    std::vector<int> input(N);
+    for (auto& v : input) v = dist(rng);
+    const int* in = input.data();
+
+    // Callables, as in the examples
+    FixedTarget<&work> direct;
+    fPtr opaquePtr = launder(&work);
+    Worker worker;
+    MethodPtr method = launder(&Worker::process);
+    WorkFunctor functor;
+    int factor = 3;
+    auto lambda = [factor](int x) { return x * factor + 1; };
+    auto bound = std::bind(workTwo, std::placeholders::_1, 3);
+    auto boundMember = std::bind(&Worker::process, &worker, std::placeholders::_1);
+    std::function<int(int)> fnLambda = lambda;
+    std::function<int(int)> fnBind = bound;
+    std::function<int(int)> fnPtr = opaquePtr;
+
+    fPtr choices[] = { work, workB, workC, workD };
+    std::vector<fPtr> mixedPtrs(N);
+    std::vector<std::function<int(int)>> mixedFns(N);
+    for (std::size_t i = 0; i < N; ++i) {
+        mixedPtrs[i] = choices[rng() % 4];
+        mixedFns[i] = mixedPtrs[i];
+    }
+    std::vector<fPtr> samePtrs(N, opaquePtr);
+
+    std::vector<Row> rows;
+    auto add = [&](const std::string& name, auto body) { rows.push_back(measure(name, N, repeats, body)); };
+
+    // Inlinable: the compiler sees the target
+    add("direct call (baseline)", [&] { auto f = [](int x) { return work(x); }; return callLoop(f, in, N); });
+    add("function pointer as template argument", [&] { return callLoop(direct, in, N); });
+    add("functor (07)", [&] { return callLoop(functor, in, N); });
+    add("lambda (08)", [&] { return callLoop(lambda, in, N); });
+    add("std::bind free function (05)", [&] { return callLoop(bound, in, N); });
+    add("std::bind member function (06)", [&] { return callLoop(boundMember, in, N); });
+
+    // Opaque: the target is only known at run time
+    add("function pointer, opaque (03)", [&] { return callLoop(opaquePtr, in, N); });
+    add("member function pointer (04)", [&] { return memberLoop(worker, method, in, N); });
+    add("std::function<lambda> (10)", [&] { return callLoop(fnLambda, in, N); });
+    add("std::function<bind> (10)", [&] { return callLoop(fnBind, in, N); });
+    add("std::function<function pointer> (10)", [&] { return callLoop(fnPtr, in, N); });
+
+    // Opaque with varying targets: one of four functions per element
+    add("pointer array, same target", [&] { return mixedPointerLoop(samePtrs.data(), in, N); });
+    add("pointer array, 4 random targets", [&] { return mixedPointerLoop(mixedPtrs.data(), in, N); });
+    add("vector<std::function>, 4 random targets", [&] { return mixedFunctionLoop(mixedFns, in, N); });
+
+    std::cout << "=== Callable dispatch cost: " << N << " calls x " << repeats << " repeats ===\n";
+    std::cout << std::left << std::setw(40) << "callable" << std::right << std::setw(10) << "ns/call"
+        << std::setw(12) << "instr/call" << std::setw(12) << "br-miss" << "\n";
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        if (i == 6) std::cout << "--- opaque ---\n";
+        if (i == 11) std::cout << "--- opaque, varying targets ---\n";
+        print(rows[i]);
+    }
+
+    // Rows computing x * 3 + 1 must agree with each other
+    bool consistent = true;
+    for (std::size_t i = 1; i <= 10; ++i) consistent = consistent && rows[i].checksum == rows[0].checksum;
+    std::cout << "\nChecksums " << (consistent ? "consistent" : "INCONSISTENT") << "\n";
+    std::cout << "Note: when the target is part of the type (functor, lambda, template argument) the call is inlined\n"
+        << "and vectorized. std::bind stores a function pointer as data, so it behaves like an opaque pointer\n"
+        << "unless the optimizer propagates it. Unpredictable targets add branch misses on top.\n";
+
+    return 0;
+}
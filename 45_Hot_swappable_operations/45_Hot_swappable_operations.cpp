@@ -0,0 +1,283 @@
+// -----------------------------
+// Demo: replacing the calculator's operations at run time without reader locks
+// -----------------------------
+// Readers get the current table with a single atomic load. Writers publish a
+// new immutable table and free the old one only after every reader has passed
+// a quiescent state (QSBR, the simplest flavour of RCU).
+//
+// A table can also come from a shared library exporting
+//     extern "C" void calculator_operations(int (*ops[4])(int, int));
+// e.g. built with: g++ -shared -fPIC -o libops.so ops.cpp
+// and passed as the first command line argument.
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+// Define basic arithmetic functions, as in 03_FunctionPointers_3
+int add(int a, int b) { return a + b; }
+int sub(int a, int b) { return a - b; }
+int mul(int a, int b) { return a * b; }
+int divide(int a, int b) { return b != 0 ? a / b : 0; } // simple check for division
+
+// A second implementation set to swap in: saturating instead of wrapping
+int addSat(int a, int b) { long long r = (long long)a + b; return r > INT32_MAX ? INT32_MAX : r < INT32_MIN ? INT32_MIN : (int)r; }
+int subSat(int a, int b) { long long r = (long long)a - b; return r > INT32_MAX ? INT32_MAX : r < INT32_MIN ? INT32_MIN : (int)r; }
+int mulSat(int a, int b) { long long r = (long long)a * b; return r > INT32_MAX ? INT32_MAX : r < INT32_MIN ? INT32_MIN : (int)r; }
+
+using fPtr = int(*)(int, int);
+
+// -----------------------------
+// Immutable operation table
+// -----------------------------
+struct OperationTable {
+    fPtr operations[4];
+    int version;
+    int check;              // version * 7: a reader seeing anything else read freed memory
+    void* library = nullptr; // shared library the functions live in, closed with the table
+
+    OperationTable(const fPtr (&ops)[4], int v, void* lib = nullptr) : version(v), check(v * 7), library(lib) {
+        std::memcpy(operations, ops, sizeof(operations));
+    }
+
+    ~OperationTable() {
+#if defined(_WIN32)
+        if (library) FreeLibrary(static_cast<HMODULE>(library));
+#else
+        if (library) dlclose(library);
+#endif
+    }
+};
+
+OperationTable* loadTable(const char* path, int version) {
+    using Entry = void(*)(fPtr*);
+#if defined(_WIN32)
+    HMODULE lib = LoadLibraryA(path);
+    if (!lib) throw std::runtime_error(std::string("cannot load ") + path);
+    auto entry = reinterpret_cast<Entry>(GetProcAddress(lib, "calculator_operations"));
+    if (!entry) { FreeLibrary(lib); throw std::runtime_error("calculator_operations not exported"); }
+#else
+    void* lib = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (!lib) throw std::runtime_error(dlerror());
+    auto entry = reinterpret_cast<Entry>(dlsym(lib, "calculator_operations"));
+    if (!entry) { dlclose(lib); throw std::runtime_error("calculator_operations not exported"); }
+#endif
+    fPtr ops[4] = {};
+    entry(ops);
+    return new OperationTable(ops, version, lib);
+}
+
+// -----------------------------
+// RCU-style holder
+// -----------------------------
+class RcuTable {
+public:
+    static constexpr int MaxReaders = 64;
+
+    // One per reader thread: it reports where the reader is, nothing else
+    class Reader {
+    public:
+        // The whole read path: one atomic load. The pointer stays valid until
+        // this reader calls quiescent() or goes offline().
+        const OperationTable* read() const { return owner->current.load(std::memory_order_acquire); }
+
+        // "I hold no table pointer right now": lets writers reclaim old tables
+        void quiescent() { slot->store(owner->epoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst); }
+
+        // For readers about to block: writers stop waiting for them
+        void offline() { slot->store(0, std::memory_order_release); }
+        void online() { quiescent(); }
+
+        ~Reader() { offline(); owner->release(slot); }
+
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+    private:
+        friend class RcuTable;
+        Reader(RcuTable* o, std::atomic<std::uint64_t>* s) : owner(o), slot(s) { quiescent(); }
+        RcuTable* owner;
+        std::atomic<std::uint64_t>* slot;
+    };
+
+    explicit RcuTable(OperationTable* initial) : current(initial) {}
+
+    ~RcuTable() { delete current.load(); }
+
+    Reader registerReader() {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        for (auto& s : slots) {
+            if (!s.used) {
+                s.used = true;
+                return Reader(this, &s.seen);
+            }
+        }
+        throw std::runtime_error("too many reader threads");
+    }
+
+    // Publish a new table, wait for a grace period, free the old one
+    void replace(OperationTable* next) {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        const OperationTable* old = current.exchange(next, std::memory_order_seq_cst);
+        std::uint64_t target = epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+
+        // Grace period: every online reader must have announced the new epoch
+        for (auto& s : slots) {
+            if (!s.used) continue;
+            for (;;) {
+                std::uint64_t seen = s.seen.load(std::memory_order_acquire);
+                if (seen == 0 || seen >= target) break;
+                std::this_thread::yield();
+            }
+        }
+
+        // Poison before freeing, so a reader that broke the rules fails its check
+        const_cast<OperationTable*>(old)->check = -1;
+        delete old;
+        ++reclaimed;
+    }
+
+    int reclaimedCount() const { return reclaimed; }
+
+private:
+    struct alignas(64) Slot {             // one cache line per reader: no false sharing
+        std::atomic<std::uint64_t> seen{ 0 };
+        bool used = false;
+    };
+
+    std::atomic<const OperationTable*> current;
+    std::atomic<std::uint64_t> epoch{ 1 };
+    Slot slots[MaxReaders];
+    std::mutex writerMutex;
+    int reclaimed = 0;
+
+    void release(std::atomic<std::uint64_t>* s) {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        for (auto& slot : slots) {
+            if (&slot.seen == s) slot.used = false;
+        }
+    }
+};
+
+// -----------------------------
+// Stress test and read-path overhead
+// -----------------------------
+struct ReaderStats {
+    long long ops = 0;
+    long long errors = 0;
+    long long sum = 0;
+};
+
+int main(int argc, char* argv[]) {
+    const fPtr standard[4] = { add, sub, mul, divide };
+    const fPtr saturating[4] = { addSat, subSat, mulSat, divide };
+
+    RcuTable table(new OperationTable(standard, 0));
+
+    std::cout << "=== Swapping operation tables under readers ===\n";
+    {
+        auto reader = table.registerReader();
+        const OperationTable* t = reader.read();
+        std::cout << "v" << t->version << " add(2, 3) = " << t->operations[0](2, 3) << "\n";
+        reader.offline(); // we are about to call replace() on this very thread
+        table.replace(new OperationTable(saturating, 1));
+        reader.online();
+        t = reader.read();
+        std::cout << "v" << t->version << " add(INT32_MAX, 1) = " << t->operations[0](INT32_MAX, 1) << " (saturating)\n";
+    }
+
+    if (argc > 1) {
+        try {
+            table.replace(loadTable(argv[1], 2));
+            std::cout << "Loaded operations from " << argv[1] << "\n";
+        }
+        catch (const std::exception& e) {
+            std::cout << "Plugin not loaded: " << e.what() << "\n";
+        }
+    }
+
+    const int numReaders = 4;
+    const auto duration = std::chrono::milliseconds(1000);
+    const int quiescentEvery = 64;
+
+    // Baseline: the same loop with a plain pointer that never changes
+    auto runBaseline = [&](ReaderStats& st, std::atomic<bool>& stop) {
+        const OperationTable* fixed = new OperationTable(standard, 0);
+        while (!stop.load(std::memory_order_relaxed)) {
+            for (int i = 0; i < quiescentEvery; ++i) {
+                if (fixed->check != fixed->version * 7) ++st.errors;
+                st.sum += fixed->operations[i & 3](i + 7, (i & 7) + 1);
+            }
+            st.ops += quiescentEvery;
+        }
+        delete fixed;
+    };
+
+    auto runRcu = [&](ReaderStats& st, std::atomic<bool>& stop) {
+        auto reader = table.registerReader();
+        while (!stop.load(std::memory_order_relaxed)) {
+            for (int i = 0; i < quiescentEvery; ++i) {
+                const OperationTable* t = reader.read();
+                if (t->check != t->version * 7) ++st.errors;
+                st.sum += t->operations[i & 3](i + 7, (i & 7) + 1);
+            }
+            st.ops += quiescentEvery;
+            reader.quiescent();
+        }
+    };
+
+    auto runReaders = [&](auto body, bool withWriter, int& swaps) {
+        std::vector<ReaderStats> stats(numReaders);
+        std::atomic<bool> stop{ false };
+        std::vector<std::thread> threads;
+        for (int r = 0; r < numReaders; ++r) threads.emplace_back([&, r] { body(stats[r], stop); });
+
+        auto start = std::chrono::steady_clock::now();
+        swaps = 0;
+        int version = 10;
+        while (std::chrono::steady_clock::now() - start < duration) {
+            if (withWriter) {
+                table.replace(new OperationTable(version % 2 ? saturating : standard, version));
+                ++version;
+                ++swaps;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        stop = true;
+        for (auto& t : threads) t.join();
+
+        ReaderStats total;
+        for (auto& s : stats) {
+            total.ops += s.ops;
+            total.errors += s.errors;
+        }
+        return total;
+    };
+
+    int swaps = 0;
+    ReaderStats baseline = runReaders(runBaseline, false, swaps);
+    ReaderStats rcu = runReaders(runRcu, true, swaps);
+
+    double seconds = std::chrono::duration<double>(duration).count();
+    std::cout << "\n=== " << numReaders << " readers for " << seconds << " s ===\n";
+    std::cout << "Plain pointer:        " << baseline.ops / seconds / 1e6 << " M ops/s\n";
+    std::cout << "RCU read + swaps:     " << rcu.ops / seconds / 1e6 << " M ops/s with " << swaps << " swaps\n";
+    std::cout << "Read-path overhead:   " << (baseline.ops > 0 ? 100.0 * (1.0 - double(rcu.ops) / baseline.ops) : 0.0) << " %\n";
+    std::cout << "Tables reclaimed:     " << table.reclaimedCount() << "\n";
+    std::cout << "Stale/freed reads:    " << rcu.errors << (rcu.errors == 0 ? " (OK)" : " (BUG)") << "\n";
+
+    return rcu.errors == 0 ? 0 : 1;
+}
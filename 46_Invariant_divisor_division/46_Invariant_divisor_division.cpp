@@ -0,0 +1,349 @@
+// -----------------------------
+// Demo: dividing a whole batch by the same divisor without a divide instruction
+// -----------------------------
+// For a fixed divisor d, n / d == (mulhi(n, M) [+/- n]) >> s, corrected by one
+// for negative quotients. M and s ("magic numbers", Granlund & Montgomery,
+// Hacker's Delight ch. 10) are computed once; each division is then a multiply,
+// a shift and a couple of adds, which also vectorizes.
+#include <iostream>
+#include <vector>
+#include <span>
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <random>
+#include <chrono>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define DIV_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#else
+#define DIV_X86 0
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define TARGET_SSE41
+#define TARGET_AVX2
+#else
+#define TARGET_SSE41 __attribute__((target("sse4.1")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+// The divide operation of 03_FunctionPointers_3, generalized to both widths
+template <typename T>
+T divide(T a, T b) { return b != 0 ? a / b : 0; }
+
+// -----------------------------
+// Signed high multiply
+// -----------------------------
+inline std::int32_t mulhi(std::int32_t a, std::int32_t b) {
+    return static_cast<std::int32_t>((static_cast<std::int64_t>(a) * b) >> 32);
+}
+
+inline std::int64_t mulhi(std::int64_t a, std::int64_t b) {
+#if defined(__SIZEOF_INT128__)
+    return static_cast<std::int64_t>((static_cast<__int128>(a) * b) >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    return __mulh(a, b);
+#else
+    // Portable fallback: split into 32-bit halves
+    std::uint64_t ua = static_cast<std::uint64_t>(a), ub = static_cast<std::uint64_t>(b);
+    std::uint64_t aLo = ua & 0xffffffffu, aHi = ua >> 32, bLo = ub & 0xffffffffu, bHi = ub >> 32;
+    std::uint64_t lolo = aLo * bLo, hilo = aHi * bLo, lohi = aLo * bHi, hihi = aHi * bHi;
+    std::uint64_t cross = (lolo >> 32) + (hilo & 0xffffffffu) + lohi;
+    std::uint64_t hi = hihi + (hilo >> 32) + (cross >> 32);
+    // unsigned high product -> signed high product
+    if (a < 0) hi -= ub;
+    if (b < 0) hi -= ua;
+    return static_cast<std::int64_t>(hi);
+#endif
+}
+
+// -----------------------------
+// Divisor<T>: precomputed magic numbers for signed 32/64-bit division
+// -----------------------------
+template <typename T>
+class Divisor {
+    static_assert(std::is_same_v<T, std::int32_t> || std::is_same_v<T, std::int64_t>, "int32_t or int64_t only");
+    using U = std::make_unsigned_t<T>;
+    static constexpr int Bits = std::numeric_limits<U>::digits;
+
+public:
+    // Zero keeps divide()'s semantics (result 0); One/MinusOne cannot be
+    // expressed with a magic multiplier; everything else is Magic.
+    enum class Mode { Zero, One, MinusOne, Magic };
+
+    explicit Divisor(T d) : d(d) {
+        if (d == 0) { mode = Mode::Zero; return; }
+        if (d == 1) { mode = Mode::One; return; }
+        if (d == -1) { mode = Mode::MinusOne; return; }
+        mode = Mode::Magic;
+
+        // Hacker's Delight, figure 10-1, for any width
+        const U twoW1 = U(1) << (Bits - 1);
+        U ad = d < 0 ? U(0) - U(d) : U(d);
+        U t = twoW1 + (U(d) >> (Bits - 1));
+        U anc = t - 1 - t % ad;
+        int p = Bits - 1;
+        U q1 = twoW1 / anc, r1 = twoW1 - q1 * anc;
+        U q2 = twoW1 / ad, r2 = twoW1 - q2 * ad;
+        U delta;
+        do {
+            ++p;
+            q1 *= 2; r1 *= 2;
+            if (r1 >= anc) { ++q1; r1 -= anc; }
+            q2 *= 2; r2 *= 2;
+            if (r2 >= ad) { ++q2; r2 -= ad; }
+            delta = ad - r2;
+        } while (q1 < delta || (q1 == delta && r1 == 0));
+
+        U m = q2 + 1;
+        if (d < 0) m = U(0) - m;
+        magic = static_cast<T>(m);
+        shift = p - Bits;
+        // When the sign of M does not match d's, the numerator must be added back
+        addMask = (d > 0 && magic < 0) ? T(-1) : T(0);
+        subMask = (d < 0 && magic > 0) ? T(-1) : T(0);
+    }
+
+    T divisor() const { return d; }
+    Mode kind() const { return mode; }
+    T multiplier() const { return magic; }
+    int shiftAmount() const { return shift; }
+    T addMaskValue() const { return addMask; }
+    T subMaskValue() const { return subMask; }
+
+    // Scalar division. n / -1 wraps for the minimum value instead of trapping.
+    T divide(T n) const {
+        switch (mode) {
+        case Mode::Zero: return 0;
+        case Mode::One: return n;
+        case Mode::MinusOne: return static_cast<T>(U(0) - U(n));
+        default: return divideMagic(n);
+        }
+    }
+
+    T divideMagic(T n) const {
+        T q = mulhi(n, magic);
+        q = static_cast<T>(U(q) + (U(n) & U(addMask)) - (U(n) & U(subMask)));
+        q >>= shift;
+        return static_cast<T>(q + static_cast<T>(U(q) >> (Bits - 1))); // round toward zero
+    }
+
+private:
+    T d;
+    Mode mode = Mode::Zero;
+    T magic = 0;
+    int shift = 0;
+    T addMask = 0, subMask = 0;
+};
+
+template <typename T>
+T operator/(T n, const Divisor<T>& d) { return d.divide(n); }
+
+// -----------------------------
+// Batch kernels for int32 (int64 has no vector high multiply before AVX-512)
+// -----------------------------
+template <typename T>
+void divideMagicScalar(const T* in, T* out, std::size_t n, const Divisor<T>& d) {
+    for (std::size_t i = 0; i < n; ++i) out[i] = d.divideMagic(in[i]);
+}
+
+#if DIV_X86
+TARGET_SSE41 void divideMagicSse(const std::int32_t* in, std::int32_t* out, std::size_t n, const Divisor<std::int32_t>& d) {
+    const __m128i m = _mm_set1_epi32(d.multiplier());
+    const __m128i addMask = _mm_set1_epi32(d.addMaskValue());
+    const __m128i subMask = _mm_set1_epi32(d.subMaskValue());
+    const __m128i shift = _mm_cvtsi32_si128(d.shiftAmount());
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        // high halves of the signed 32x32 products, even and odd lanes separately
+        __m128i even = _mm_srli_epi64(_mm_mul_epi32(x, m), 32);
+        __m128i odd = _mm_mul_epi32(_mm_srli_epi64(x, 32), m);
+        __m128i q = _mm_blend_epi16(even, odd, 0xCC);
+        q = _mm_sub_epi32(_mm_add_epi32(q, _mm_and_si128(x, addMask)), _mm_and_si128(x, subMask));
+        q = _mm_sra_epi32(q, shift);
+        q = _mm_add_epi32(q, _mm_srli_epi32(q, 31));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), q);
+    }
+    divideMagicScalar(in + i, out + i, n - i, d);
+}
+
+TARGET_AVX2 void divideMagicAvx2(const std::int32_t* in, std::int32_t* out, std::size_t n, const Divisor<std::int32_t>& d) {
+    const __m256i m = _mm256_set1_epi32(d.multiplier());
+    const __m256i addMask = _mm256_set1_epi32(d.addMaskValue());
+    const __m256i subMask = _mm256_set1_epi32(d.subMaskValue());
+    const __m128i shift = _mm_cvtsi32_si128(d.shiftAmount());
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        __m256i even = _mm256_srli_epi64(_mm256_mul_epi32(x, m), 32);
+        __m256i odd = _mm256_mul_epi32(_mm256_srli_epi64(x, 32), m);
+        __m256i q = _mm256_blend_epi32(even, odd, 0xAA);
+        q = _mm256_sub_epi32(_mm256_add_epi32(q, _mm256_and_si256(x, addMask)), _mm256_and_si256(x, subMask));
+        q = _mm256_sra_epi32(q, shift);
+        q = _mm256_add_epi32(q, _mm256_srli_epi32(q, 31));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), q);
+    }
+    divideMagicScalar(in + i, out + i, n - i, d);
+}
+#endif
+
+enum class Isa { Scalar, Sse41, Avx2 };
+
+Isa detectIsa() {
+#if DIV_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+    int regs[4];
+    __cpuid(regs, 0);
+    int maxLeaf = regs[0];
+    bool sse41 = false, avx2 = false;
+    if (maxLeaf >= 1) {
+        __cpuid(regs, 1);
+        sse41 = (regs[2] & (1 << 19)) != 0;
+        bool ymmEnabled = (regs[2] & (1 << 27)) && (regs[2] & (1 << 28)) && (_xgetbv(0) & 0x6) == 0x6;
+        if (maxLeaf >= 7 && ymmEnabled) {
+            __cpuidex(regs, 7, 0);
+            avx2 = (regs[1] & (1 << 5)) != 0;
+        }
+    }
+    if (avx2) return Isa::Avx2;
+    if (sse41) return Isa::Sse41;
+#else
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return Isa::Avx2;
+    if (__builtin_cpu_supports("sse4.1")) return Isa::Sse41;
+#endif
+#endif
+    return Isa::Scalar;
+}
+
+const Isa bestIsa = detectIsa();
+
+// -----------------------------
+// Batch entry points: the divisor's mode is checked once per batch
+// -----------------------------
+// out[i] = in[i] / d for every element of in; out must be at least as long
+template <typename T>
+void divide(std::span<const T> in, const Divisor<T>& d, std::span<T> out) {
+    if (out.size() < in.size()) throw std::invalid_argument("divide: output too small");
+    const std::size_t n = in.size();
+    switch (d.kind()) {
+    case Divisor<T>::Mode::Zero:
+        for (std::size_t i = 0; i < n; ++i) out[i] = 0;
+        return;
+    case Divisor<T>::Mode::One:
+        for (std::size_t i = 0; i < n; ++i) out[i] = in[i];
+        return;
+    case Divisor<T>::Mode::MinusOne:
+        for (std::size_t i = 0; i < n; ++i) out[i] = d.divide(in[i]);
+        return;
+    default:
+        break;
+    }
+#if DIV_X86
+    if constexpr (std::is_same_v<T, std::int32_t>) {
+        if (bestIsa == Isa::Avx2) return divideMagicAvx2(in.data(), out.data(), n, d);
+        if (bestIsa == Isa::Sse41) return divideMagicSse(in.data(), out.data(), n, d);
+    }
+#endif
+    divideMagicScalar(in.data(), out.data(), n, d);
+}
+
+// In place
+template <typename T>
+void divide(std::span<T> values, const Divisor<T>& d) {
+    divide(std::span<const T>(values.data(), values.size()), d, values);
+}
+
+// -----------------------------
+// Verification and benchmark
+// -----------------------------
+template <typename T>
+bool verify(std::mt19937_64& rng) {
+    const T minV = std::numeric_limits<T>::min(), maxV = std::numeric_limits<T>::max();
+    std::vector<T> divisors = { 0, 1, 2, 3, 5, 7, 10, 16, 641, 1000, 65536, maxV, maxV - 1, minV, minV + 1 };
+    for (int i = 0; i < 200; ++i) divisors.push_back(static_cast<T>(rng()) >> (rng() % (sizeof(T) * 8)));
+    std::size_t count = divisors.size();
+    for (std::size_t i = 0; i < count; ++i) if (divisors[i] != minV) divisors.push_back(-divisors[i]);
+
+    std::vector<T> numerators = { 0, 1, -1, 2, -2, maxV, minV + 1, maxV - 1 };
+    for (int i = 0; i < 2000; ++i) numerators.push_back(static_cast<T>(rng()) >> (rng() % (sizeof(T) * 8)));
+    std::vector<T> out(numerators.size());
+
+    for (T dv : divisors) {
+        Divisor<T> d(dv);
+        divide<T>(numerators, d, out);
+        for (std::size_t i = 0; i < numerators.size(); ++i) {
+            T n = numerators[i];
+            if (dv == -1) continue; // covered by the minimum-value test below
+            if (out[i] != divide(n, dv) || n / d != out[i]) {
+                std::cout << "Mismatch: " << n << " / " << dv << " = " << divide(n, dv) << ", got " << out[i] << "\n";
+                return false;
+            }
+        }
+    }
+    // Also the minimum value against every non -1 divisor
+    for (T dv : divisors) {
+        if (dv == -1) continue;
+        if (minV / Divisor<T>(dv) != divide(minV, dv)) return false;
+    }
+    return Divisor<T>(-1).divide(minV) == minV && Divisor<T>(-1).divide(5) == -5;
+}
+
+int main() {
+    std::mt19937_64 rng(99);
+    const char* isaNames[] = { "scalar", "SSE4.1", "AVX2" };
+    std::cout << "=== Invariant divisor division (" << isaNames[static_cast<int>(bestIsa)] << ") ===\n";
+    std::cout << "int32 verification: " << (verify<std::int32_t>(rng) ? "OK" : "FAILED") << "\n";
+    std::cout << "int64 verification: " << (verify<std::int64_t>(rng) ? "OK" : "FAILED") << "\n";
+
+    Divisor<std::int32_t> seven(7);
+    std::cout << "7: multiplier " << seven.multiplier() << ", shift " << seven.shiftAmount()
+        << ", -100 / 7 = " << -100 / seven << "\n";
+
+    const std::size_t N = 1 << 20;
+    const int repeats = 50;
+    std::vector<std::int32_t> in32(N), expected32(N), out32(N);
+    std::vector<std::int64_t> in64(N), expected64(N), out64(N);
+    for (std::size_t i = 0; i < N; ++i) {
+        in32[i] = static_cast<std::int32_t>(rng());
+        in64[i] = static_cast<std::int64_t>(rng());
+    }
+
+    // volatile: the divisor arrives at run time, so the compiler cannot do this itself
+    volatile std::int32_t divisorSource = 641;
+    std::int32_t dv32 = divisorSource;
+    std::int64_t dv64 = divisorSource;
+
+    auto time = [&](auto body) {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int r = 0; r < repeats; ++r) body();
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double>(end - start).count();
+    };
+
+    double hw32 = time([&] { for (std::size_t i = 0; i < N; ++i) expected32[i] = divide(in32[i], dv32); });
+    Divisor<std::int32_t> d32(dv32);
+    double magic32 = time([&] { divide<std::int32_t>(in32, d32, out32); });
+    bool ok32 = expected32 == out32;
+
+    double hw64 = time([&] { for (std::size_t i = 0; i < N; ++i) expected64[i] = divide(in64[i], dv64); });
+    Divisor<std::int64_t> d64(dv64);
+    double magic64 = time([&] { divide<std::int64_t>(in64, d64, out64); });
+    bool ok64 = expected64 == out64;
+
+    std::cout << "\n=== " << N << " divisions by " << dv32 << " x " << repeats << " repeats ===\n";
+    std::cout << "int32 hardware divide: " << hw32 << " s, Divisor batch: " << magic32 << " s (x" << hw32 / magic32 << ")"
+        << (ok32 ? "" : "  MISMATCH!") << "\n";
+    std::cout << "int64 hardware divide: " << hw64 << " s, Divisor batch: " << magic64 << " s (x" << hw64 / magic64 << ")"
+        << (ok64 ? "" : "  MISMATCH!") << "\n";
+
+    return 0;
+}
@@ -0,0 +1,293 @@
+#include <iostream>
+#include <functional> // std::bind, for comparison
+#include <tuple>
+#include <array>
+#include <utility>
+#include <type_traits>
+#include <chrono>
+
+// ===============================================================
+// pa: partial application without std::bind's overhead
+// ===============================================================
+// - pa::bind_front / pa::bind_back fix leading / trailing arguments
+// - pa::bind accepts pa::_1, pa::_2, ... to reorder call arguments,
+//   resolved entirely at compile time
+// - everything is constexpr
+// - bound values are laid out by decreasing alignment, so no padding is
+//   wasted between them, and empty ones (placeholders, stateless callables)
+//   take no space at all
+namespace pa {
+
+// ---------------------------------------------------------------
+// Placeholders
+// ---------------------------------------------------------------
+template <std::size_t N>
+struct Arg {
+    static_assert(N >= 1, "placeholders start at _1");
+    static constexpr std::size_t index = N - 1;
+};
+
+inline constexpr Arg<1> _1{};
+inline constexpr Arg<2> _2{};
+inline constexpr Arg<3> _3{};
+inline constexpr Arg<4> _4{};
+
+template <typename T> struct is_placeholder : std::false_type {};
+template <std::size_t N> struct is_placeholder<Arg<N>> : std::true_type {};
+
+// A function as a template argument: an empty callable, so calls through it
+// are direct (std::bind stores a function pointer as data instead)
+template <auto F>
+struct fn_t {
+    template <typename... A>
+    constexpr decltype(auto) operator()(A&&... a) const { return std::invoke(F, std::forward<A>(a)...); }
+};
+
+template <auto F>
+inline constexpr fn_t<F> fn{};
+
+// ---------------------------------------------------------------
+// Padding-free storage
+// ---------------------------------------------------------------
+template <typename... Ts>
+struct Layout {
+    static constexpr std::size_t size = sizeof...(Ts);
+
+    // order[k] = original index of the element stored at position k
+    static constexpr std::array<std::size_t, size> order = [] {
+        std::array<std::size_t, size> o{};
+        std::array<std::size_t, size> align{ alignof(Ts)... };
+        for (std::size_t i = 0; i < size; ++i) o[i] = i;
+        for (std::size_t i = 1; i < size; ++i) { // stable insertion sort, largest alignment first
+            std::size_t v = o[i], j = i;
+            for (; j > 0 && align[o[j - 1]] < align[v]; --j) o[j] = o[j - 1];
+            o[j] = v;
+        }
+        return o;
+    }();
+
+    // position[i] = where the element with original index i is stored
+    static constexpr std::array<std::size_t, size> position = [] {
+        std::array<std::size_t, size> p{};
+        for (std::size_t k = 0; k < size; ++k) p[order[k]] = k;
+        return p;
+    }();
+};
+
+// Empty types are stored as base classes (empty base optimization): they
+// take no space. Everything else is a plain member.
+template <std::size_t Pos, typename T, bool Empty = std::is_empty_v<T> && !std::is_final_v<T>>
+struct Slot {
+    T value;
+
+    template <typename A>
+    constexpr Slot(std::in_place_t, A&& a) : value(std::forward<A>(a)) {}
+    constexpr T& get() { return value; }
+    constexpr const T& get() const { return value; }
+};
+
+template <std::size_t Pos, typename T>
+struct Slot<Pos, T, true> : T {
+    template <typename A>
+    constexpr Slot(std::in_place_t, A&& a) : T(std::forward<A>(a)) {}
+    constexpr T& get() { return *this; }
+    constexpr const T& get() const { return *this; }
+};
+
+template <typename Tuple, typename Seq>
+struct PackedStorage;
+
+template <typename... Ts, std::size_t... K>
+struct PackedStorage<std::tuple<Ts...>, std::index_sequence<K...>>
+    : Slot<K, std::tuple_element_t<Layout<Ts...>::order[K], std::tuple<Ts...>>>... {
+    using L = Layout<Ts...>;
+
+    template <std::size_t I>
+    using type = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+    // args are in declaration order; each slot picks its own.
+    // The in_place_t tag keeps these templates from hijacking copy construction.
+    template <typename ArgsTuple>
+    constexpr PackedStorage(std::in_place_t, ArgsTuple&& args)
+        : Slot<K, type<L::order[K]>>(std::in_place, std::get<L::order[K]>(std::forward<ArgsTuple>(args)))... {
+    }
+
+    template <std::size_t I>
+    constexpr type<I>& get() { return static_cast<Slot<L::position[I], type<I>>&>(*this).get(); }
+
+    template <std::size_t I>
+    constexpr const type<I>& get() const { return static_cast<const Slot<L::position[I], type<I>>&>(*this).get(); }
+};
+
+template <typename... Ts>
+using Packed = PackedStorage<std::tuple<Ts...>, std::index_sequence_for<Ts...>>;
+
+// ---------------------------------------------------------------
+// The partial application object
+// ---------------------------------------------------------------
+enum class Mode { Front, Back, Placeholders };
+
+template <Mode M, typename F, typename... Bound>
+class Partial {
+public:
+    template <typename... A>
+    constexpr Partial(std::in_place_t, A&&... a) : storage(std::in_place, std::forward_as_tuple(std::forward<A>(a)...)) {}
+
+    template <typename... Call>
+    constexpr decltype(auto) operator()(Call&&... call) & {
+        return apply(*this, std::index_sequence_for<Bound...>{}, std::forward<Call>(call)...);
+    }
+
+    template <typename... Call>
+    constexpr decltype(auto) operator()(Call&&... call) const& {
+        return apply(*this, std::index_sequence_for<Bound...>{}, std::forward<Call>(call)...);
+    }
+
+private:
+    Packed<F, Bound...> storage; // element 0 is the callable
+
+    template <typename Self, std::size_t... I, typename... Call>
+    static constexpr decltype(auto) apply(Self& self, std::index_sequence<I...>, Call&&... call) {
+        auto& f = self.storage.template get<0>();
+        if constexpr (M == Mode::Front) {
+            return std::invoke(f, self.storage.template get<I + 1>()..., std::forward<Call>(call)...);
+        }
+        else if constexpr (M == Mode::Back) {
+            return std::invoke(f, std::forward<Call>(call)..., self.storage.template get<I + 1>()...);
+        }
+        else {
+            auto callArgs = std::forward_as_tuple(std::forward<Call>(call)...);
+            return std::invoke(f, resolve<I>(self, callArgs)...);
+        }
+    }
+
+    // A bound value, or the call argument a placeholder points at
+    template <std::size_t I, typename Self, typename CallTuple>
+    static constexpr decltype(auto) resolve(Self& self, CallTuple& callArgs) {
+        using T = std::tuple_element_t<I, std::tuple<Bound...>>;
+        if constexpr (is_placeholder<T>::value) {
+            static_assert(T::index < std::tuple_size_v<CallTuple>, "placeholder refers to a missing call argument");
+            return std::get<T::index>(std::move(callArgs));
+        }
+        else {
+            return (self.storage.template get<I + 1>());
+        }
+    }
+};
+
+template <typename F, typename... A>
+constexpr auto bind_front(F&& f, A&&... a) {
+    return Partial<Mode::Front, std::decay_t<F>, std::decay_t<A>...>(std::in_place, std::forward<F>(f), std::forward<A>(a)...);
+}
+
+template <typename F, typename... A>
+constexpr auto bind_back(F&& f, A&&... a) {
+    return Partial<Mode::Back, std::decay_t<F>, std::decay_t<A>...>(std::in_place, std::forward<F>(f), std::forward<A>(a)...);
+}
+
+template <typename F, typename... A>
+constexpr auto bind(F&& f, A&&... a) {
+    return Partial<Mode::Placeholders, std::decay_t<F>, std::decay_t<A>...>(std::in_place, std::forward<F>(f), std::forward<A>(a)...);
+}
+
+} // namespace pa
+
+// ===============================================================
+// 1. The examples of 05_stdBind_1, at compile time
+// ===============================================================
+constexpr int compute(int a, int b, int c) {
+    return a + 2 * b + 3 * c;
+}
+
+constexpr auto boundFunc1 = pa::bind(pa::fn<compute>, 10, pa::_1, pa::_2);
+constexpr auto boundFunc2 = pa::bind_front(pa::fn<compute>, 1, 2);
+constexpr auto boundFunc3 = pa::bind(pa::fn<compute>, pa::_2, pa::_1, 5);
+
+static_assert(boundFunc1(5, 2) == compute(10, 5, 2));
+static_assert(boundFunc2(3) == compute(1, 2, 3));
+static_assert(boundFunc3(7, 4) == compute(4, 7, 5));
+static_assert(pa::bind_back(pa::fn<compute>, 5)(1, 2) == compute(1, 2, 5));
+
+// Same size as the equivalent lambda: only the int 5 is stored
+constexpr auto lambda3 = [c = 5](int x, int y) { return compute(y, x, c); };
+static_assert(sizeof(boundFunc3) == sizeof(lambda3));
+
+// ===============================================================
+// 2. Storage without padding
+// ===============================================================
+struct Mixed {
+    constexpr double operator()(char a, double b, char c, int d) const { return a + b + c + d; }
+};
+
+// ===============================================================
+// 3. Generated code: compare these two with a disassembler
+// ===============================================================
+// e.g. objdump -d --no-show-raw-insn | grep -A8 viaPartial / viaLambda
+#if defined(_MSC_VER)
+#define NOINLINE __declspec(noinline)
+#else
+#define NOINLINE __attribute__((noinline))
+#endif
+
+NOINLINE int viaStdBind(int x, int y) {
+    static const auto f = std::bind(compute, std::placeholders::_2, std::placeholders::_1, 5);
+    return f(x, y);
+}
+
+NOINLINE int viaPartial(int x, int y) {
+    return boundFunc3(x, y);
+}
+
+NOINLINE int viaLambda(int x, int y) {
+    return lambda3(x, y);
+}
+
+template <typename F>
+double timeCalls(F f, long long& sum) {
+    volatile int seed = 3; // keeps the inputs opaque
+    int s = seed;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < 100'000'000; ++i) sum += f(i, s);
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+int main() {
+    std::cout << "=== Same results as 05_stdBind_1 ===\n";
+    std::cout << "boundFunc1(5, 2) = " << boundFunc1(5, 2) << "\n";
+    std::cout << "boundFunc2(3)    = " << boundFunc2(3) << "\n";
+    std::cout << "boundFunc3(7, 4) = " << boundFunc3(7, 4) << "\n";
+
+    std::cout << "\n=== Object sizes ===\n";
+    auto stdBound3 = std::bind(compute, std::placeholders::_2, std::placeholders::_1, 5);
+    std::cout << "std::bind(compute, _2, _1, 5):       " << sizeof(stdBound3) << " bytes\n";
+    std::cout << "pa::bind(fn<compute>, _2, _1, 5):    " << sizeof(boundFunc3) << " bytes\n";
+    std::cout << "[c = 5](x, y) { compute(y, x, c) }:  " << sizeof(lambda3) << " bytes\n";
+
+    char c1 = 'a', c2 = 'b';
+    double d = 1.5;
+    int i = 7;
+    auto stdMixed = std::bind(Mixed{}, c1, d, c2, i);
+    auto paMixed = pa::bind_front(Mixed{}, c1, d, c2, i);
+    auto lambdaMixed = [c1, d, c2, i] { return Mixed{}(c1, d, c2, i); };
+    std::cout << "\nBinding (char, double, char, int):\n";
+    std::cout << "std::bind: " << sizeof(stdMixed) << " bytes, lambda: " << sizeof(lambdaMixed)
+        << " bytes, pa::bind_front: " << sizeof(paMixed) << " bytes (values " << paMixed() << ")\n";
+
+    // Copies are plain copies of the packed values, also into std::function
+    auto paCopy = paMixed;
+    std::function<int(int, int)> stored = boundFunc3;
+    std::cout << "copy: " << paCopy() << ", through std::function: " << stored(7, 4) << "\n";
+
+    std::cout << "\n=== 100M calls ===\n";
+    long long s1 = 0, s2 = 0, s3 = 0;
+    double tBind = timeCalls(viaStdBind, s1);
+    double tPartial = timeCalls(viaPartial, s2);
+    double tLambda = timeCalls(viaLambda, s3);
+    std::cout << "std::bind:  " << tBind << " s\n";
+    std::cout << "pa::bind:   " << tPartial << " s\n";
+    std::cout << "lambda:     " << tLambda << " s\n";
+    std::cout << "Checksums " << (s1 == s2 && s2 == s3 ? "match" : "DIFFER") << "\n";
+
+    return 0;
+}
@@ -0,0 +1,283 @@
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <optional>
+#include <cstdint>
+#include <utility>
+#include <chrono>
+
+// Same Calculator as 06_stdBind_2, but the id lives inside the object
+// instead of in a separate heap allocation
+class Calculator
+{
+private:
+	inline static int nextIdValue{ 1 };  // static counter for IDs
+	int id;
+
+public:
+	Calculator() : id(nextIdValue++) {}
+
+	int getId() const
+	{
+		return id;
+	}
+
+	int add(int a, int b)
+	{
+		return a + b;
+	}
+};
+
+// -----------------------------
+// Generational slot map
+// -----------------------------
+// Objects live contiguously in `dense`. A Handle names a slot plus the
+// generation it was issued for; erasing bumps the slot's generation, so every
+// old handle to it stops resolving instead of dangling.
+struct Handle
+{
+	std::uint32_t index = 0;
+	std::uint32_t generation = 0; // 0 is never issued: a default Handle is always invalid
+};
+
+template <typename T>
+class SlotMap
+{
+public:
+	// If T's constructor (or an allocation) throws, the map is unchanged
+	template <typename... Args>
+	Handle insert(Args&&... args)
+	{
+		// Everything that can throw comes first...
+		if (freeHead == NoSlot) growForOne(slots);
+		growForOne(denseToSlot);
+		dense.emplace_back(std::forward<Args>(args)...);
+
+		// ...then the slot is committed, which cannot fail
+		std::uint32_t slotIndex;
+		if (freeHead != NoSlot) {
+			slotIndex = freeHead;
+			freeHead = slots[slotIndex].denseOrNext;
+		}
+		else {
+			slotIndex = static_cast<std::uint32_t>(slots.size());
+			slots.push_back({ 0, 1 });
+		}
+		Slot& s = slots[slotIndex];
+		s.denseOrNext = static_cast<std::uint32_t>(dense.size() - 1);
+		denseToSlot.push_back(slotIndex);
+		return { slotIndex, s.generation };
+	}
+
+	// nullptr once the object has been erased (or the handle never existed)
+	T* get(Handle h)
+	{
+		if (h.index >= slots.size()) return nullptr;
+		const Slot& s = slots[h.index];
+		return s.generation == h.generation ? &dense[s.denseOrNext] : nullptr;
+	}
+
+	bool contains(Handle h) const
+	{
+		return h.index < slots.size() && slots[h.index].generation == h.generation;
+	}
+
+	// Swap-and-pop keeps `dense` contiguous; the moved object's slot is patched
+	bool erase(Handle h)
+	{
+		if (!contains(h)) return false;
+		Slot& s = slots[h.index];
+		std::uint32_t pos = s.denseOrNext;
+		std::uint32_t last = static_cast<std::uint32_t>(dense.size() - 1);
+		if (pos != last) {
+			dense[pos] = std::move(dense[last]);
+			denseToSlot[pos] = denseToSlot[last];
+			slots[denseToSlot[pos]].denseOrNext = pos;
+		}
+		dense.pop_back();
+		denseToSlot.pop_back();
+
+		if (++s.generation == 0) s.generation = 1; // skip 0 on wrap-around
+		s.denseOrNext = freeHead;
+		freeHead = h.index;
+		return true;
+	}
+
+	std::size_t size() const { return dense.size(); }
+
+	void reserve(std::size_t n)
+	{
+		slots.reserve(n);
+		dense.reserve(n);
+		denseToSlot.reserve(n);
+	}
+
+	// Iteration over live objects only, in memory order
+	auto begin() { return dense.begin(); }
+	auto end() { return dense.end(); }
+
+private:
+	static constexpr std::uint32_t NoSlot = 0xffffffffu;
+
+	struct Slot
+	{
+		std::uint32_t denseOrNext; // live: position in dense, free: next free slot
+		std::uint32_t generation;
+	};
+
+	// Makes room for one more element up front (doubling, like push_back would)
+	template <typename V>
+	static void growForOne(std::vector<V>& v)
+	{
+		if (v.size() == v.capacity()) v.reserve(v.empty() ? 8 : 2 * v.size());
+	}
+
+	std::vector<Slot> slots;
+	std::vector<T> dense;
+	std::vector<std::uint32_t> denseToSlot;
+	std::uint32_t freeHead = NoSlot;
+};
+
+// -----------------------------
+// Bound member call through a handle
+// -----------------------------
+// The std::bind replacement: instead of a raw Calculator* it holds the map
+// and a handle, and the call checks the generation first.
+template <typename T, typename R, typename... Args>
+class SafeBound
+{
+public:
+	using Method = R(T::*)(Args...);
+
+	SafeBound(SlotMap<T>& m, Handle h, Method f) : map(&m), handle(h), method(f) {}
+
+	std::optional<R> operator()(Args... args) const
+	{
+		T* obj = map->get(handle);
+		if (!obj) return std::nullopt;
+		return (obj->*method)(args...);
+	}
+
+private:
+	SlotMap<T>* map;
+	Handle handle;
+	Method method;
+};
+
+template <typename T, typename R, typename... Args>
+SafeBound<T, R, Args...> bindHandle(SlotMap<T>& map, Handle h, R(T::* method)(Args...))
+{
+	return SafeBound<T, R, Args...>(map, h, method);
+}
+
+// The shared_ptr/weak_ptr design we compare against
+template <typename T, typename R, typename... Args>
+class WeakBound
+{
+public:
+	using Method = R(T::*)(Args...);
+
+	WeakBound(const std::shared_ptr<T>& p, Method f) : weak(p), method(f) {}
+
+	std::optional<R> operator()(Args... args) const
+	{
+		std::shared_ptr<T> obj = weak.lock(); // atomic increment and decrement on every call
+		if (!obj) return std::nullopt;
+		return (obj.get()->*method)(args...);
+	}
+
+private:
+	std::weak_ptr<T> weak;
+	Method method;
+};
+
+int main()
+{
+	std::cout << "=== Bound calls through generation-checked handles ===\n";
+	SlotMap<Calculator> calculators;
+	Handle h1 = calculators.insert();
+	Handle h2 = calculators.insert();
+
+	auto boundAdd1 = bindHandle(calculators, h1, &Calculator::add);
+	auto boundAdd2 = bindHandle(calculators, h2, &Calculator::add);
+	std::cout << "calc " << calculators.get(h1)->getId() << ": add(10, 5) = " << *boundAdd1(10, 5) << "\n";
+	std::cout << "calc " << calculators.get(h2)->getId() << ": add(3, 7) = " << *boundAdd2(3, 7) << "\n";
+
+	std::cout << "Erasing calc " << calculators.get(h1)->getId() << "...\n";
+	calculators.erase(h1);
+	Handle h3 = calculators.insert(); // reuses h1's slot with a new generation
+
+	auto result = boundAdd1(2, 2);
+	std::cout << "Calling after erase: " << (result ? std::to_string(*result) : std::string("no object (no crash)")) << "\n";
+	std::cout << "Old handle slot " << h1.index << " gen " << h1.generation << ", new handle slot "
+		<< h3.index << " gen " << h3.generation << " -> calc " << calculators.get(h3)->getId() << "\n";
+	std::cout << "calc " << calculators.get(h2)->getId() << " still works: add(1, 1) = " << *boundAdd2(1, 1) << "\n";
+
+	// -----------------------------
+	// Benchmarks
+	// -----------------------------
+	const int N = 1'000'000;
+	const int callRounds = 20;
+
+	SlotMap<Calculator> map;
+	map.reserve(N);
+	std::vector<SafeBound<Calculator, int, int, int>> safeCalls;
+	std::vector<std::shared_ptr<Calculator>> owners;
+	std::vector<WeakBound<Calculator, int, int, int>> weakCalls;
+	safeCalls.reserve(N);
+	owners.reserve(N);
+	weakCalls.reserve(N);
+
+	auto start = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < N; ++i) safeCalls.push_back(bindHandle(map, map.insert(), &Calculator::add));
+	auto end = std::chrono::high_resolution_clock::now();
+	double createSlot = std::chrono::duration<double>(end - start).count();
+
+	start = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < N; ++i) {
+		owners.push_back(std::make_shared<Calculator>());
+		weakCalls.emplace_back(owners.back(), &Calculator::add);
+	}
+	end = std::chrono::high_resolution_clock::now();
+	double createShared = std::chrono::duration<double>(end - start).count();
+
+	long long sumSlot = 0, sumWeak = 0;
+	start = std::chrono::high_resolution_clock::now();
+	for (int r = 0; r < callRounds; ++r)
+		for (int i = 0; i < N; ++i) sumSlot += *safeCalls[i](i, r);
+	end = std::chrono::high_resolution_clock::now();
+	double callSlot = std::chrono::duration<double>(end - start).count();
+
+	start = std::chrono::high_resolution_clock::now();
+	for (int r = 0; r < callRounds; ++r)
+		for (int i = 0; i < N; ++i) sumWeak += *weakCalls[i](i, r);
+	end = std::chrono::high_resolution_clock::now();
+	double callWeak = std::chrono::duration<double>(end - start).count();
+
+	// Destroy every other object: handles/weak_ptrs to them must now fail
+	start = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < N; i += 2) map.erase(Handle{ static_cast<std::uint32_t>(i), 1 });
+	end = std::chrono::high_resolution_clock::now();
+	double destroySlot = std::chrono::duration<double>(end - start).count();
+
+	start = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < N; i += 2) owners[i].reset();
+	end = std::chrono::high_resolution_clock::now();
+	double destroyShared = std::chrono::duration<double>(end - start).count();
+
+	int deadSlot = 0, deadWeak = 0;
+	for (int i = 0; i < N; ++i) {
+		deadSlot += !safeCalls[i](1, 2);
+		deadWeak += !weakCalls[i](1, 2);
+	}
+
+	std::cout << "\n=== " << N << " calculators ===\n";
+	std::cout << "Create + bind:   slot map " << createSlot << " s, shared_ptr " << createShared << " s\n";
+	std::cout << "Destroy half:    slot map " << destroySlot << " s, shared_ptr " << destroyShared << " s\n";
+	std::cout << "Bound calls (x" << callRounds << "): slot map " << callSlot << " s, weak_ptr::lock " << callWeak
+		<< " s (x" << callWeak / callSlot << ")\n";
+	std::cout << "Dead handles detected: " << deadSlot << " / " << deadWeak << " expected " << N / 2
+		<< ", checksums " << (sumSlot == sumWeak ? "match" : "DIFFER") << "\n";
+
+	return 0;
+}
@@ -0,0 +1,280 @@
+// -----------------------------
+// memoize: a bounded, sharded result cache for pure callables
+// -----------------------------
+// - the argument tuple is the key, hashed element by element
+// - the capacity is split across the shards (the remainder goes one entry each
+//   to the first shards), so the cache never holds more than the caller asked for
+// - a full shard evicts with CLOCK:
+//   a hit only sets a "referenced" flag, so lookups run under a shared lock
+//   and never reorder anything (an LRU list would need the exclusive lock)
+// - shards are picked by hash, so threads calling with different arguments
+//   rarely touch the same lock
+// - works with anything callable: function pointers, lambdas, std::bind
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <tuple>
+#include <memory>
+#include <functional>
+#include <random>
+#include <chrono>
+#include <cstdint>
+
+// -----------------------------
+// Hashing argument tuples
+// -----------------------------
+struct TupleHash {
+    template <typename... Ts>
+    std::size_t operator()(const std::tuple<Ts...>& t) const {
+        std::size_t h = 0;
+        std::apply([&](const Ts&... v) { ((h = combine(h, std::hash<Ts>{}(v))), ...); }, t);
+        return h;
+    }
+
+    static std::size_t combine(std::size_t seed, std::size_t v) {
+        return seed ^ (v + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+    }
+};
+
+// std::hash<int> is the identity on common implementations: mix before taking shard bits
+inline std::uint64_t mix(std::uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    return x;
+}
+
+struct CacheStats {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t evictions = 0;
+
+    double hitRate() const { return hits + misses ? 100.0 * hits / (hits + misses) : 0.0; }
+};
+
+// -----------------------------
+// The memoizing wrapper
+// -----------------------------
+template <typename F, typename... Args>
+class Memoized {
+public:
+    using Key = std::tuple<std::decay_t<Args>...>;
+    using Result = std::decay_t<std::invoke_result_t<const F&, const Args&...>>;
+
+    Memoized(F f, std::size_t capacity, std::size_t shardCount)
+        : fn(std::move(f)), shardMask(roundUpPow2(shardCount) - 1), shards(new Shard[shardMask + 1]) {
+        std::size_t n = shardMask + 1;
+        for (std::size_t i = 0; i < n; ++i) {
+            shards[i].capacity = capacity / n + (i < capacity % n ? 1 : 0);
+        }
+    }
+
+    Result operator()(const Args&... args) const {
+        Key key(args...);
+        std::size_t h = TupleHash{}(key);
+        Shard& s = shards[mix(h) & shardMask];
+
+        {
+            std::shared_lock<std::shared_mutex> lock(s.mutex);
+            auto it = s.index.find(key);
+            if (it != s.index.end()) {
+                Entry& e = s.entries[it->second];
+                e.referenced.store(true, std::memory_order_relaxed);
+                s.hits.fetch_add(1, std::memory_order_relaxed);
+                return e.value;
+            }
+        }
+
+        // Compute outside the lock: the function is pure, so a racing thread
+        // computing the same key only wastes work, it cannot disagree
+        s.misses.fetch_add(1, std::memory_order_relaxed);
+        Result value = std::invoke(fn, args...);
+
+        std::unique_lock<std::shared_mutex> lock(s.mutex);
+        if (s.capacity == 0 || s.index.count(key)) return value; // capacity < shards: this one never caches
+        if (s.entries.size() < s.capacity) {
+            s.index.emplace(key, s.entries.size());
+            s.entries.emplace_back(std::move(key), value);
+            return value;
+        }
+
+        // CLOCK: skip (and clear) referenced entries, evict the first cold one
+        while (s.entries[s.hand].referenced.exchange(false, std::memory_order_relaxed)) {
+            s.hand = (s.hand + 1) % s.capacity;
+        }
+        Entry& victim = s.entries[s.hand];
+        s.index.erase(victim.key);
+        victim.key = std::move(key);
+        victim.value = value;
+        s.index.emplace(victim.key, s.hand);
+        s.hand = (s.hand + 1) % s.capacity;
+        s.evictions.fetch_add(1, std::memory_order_relaxed);
+        return value;
+    }
+
+    CacheStats stats() const {
+        CacheStats total;
+        for (std::size_t i = 0; i <= shardMask; ++i) {
+            total.hits += shards[i].hits.load(std::memory_order_relaxed);
+            total.misses += shards[i].misses.load(std::memory_order_relaxed);
+            total.evictions += shards[i].evictions.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    std::size_t size() const {
+        std::size_t n = 0;
+        for (std::size_t i = 0; i <= shardMask; ++i) {
+            std::shared_lock<std::shared_mutex> lock(shards[i].mutex);
+            n += shards[i].entries.size();
+        }
+        return n;
+    }
+
+private:
+    struct Entry {
+        Key key;
+        Result value;
+        std::atomic<bool> referenced{ false }; // set by hits under the shared lock
+
+        Entry(Key k, Result v) : key(std::move(k)), value(std::move(v)) {}
+    };
+
+    struct alignas(64) Shard { // one cache line apart: counters do not false-share
+        std::shared_mutex mutex;
+        std::unordered_map<Key, std::size_t, TupleHash> index;
+        std::deque<Entry> entries; // deque: Entry holds an atomic, so it never moves
+        std::size_t capacity = 0;
+        std::size_t hand = 0;
+        std::atomic<std::uint64_t> hits{ 0 };
+        std::atomic<std::uint64_t> misses{ 0 };
+        std::atomic<std::uint64_t> evictions{ 0 };
+    };
+
+    static std::size_t roundUpPow2(std::size_t n) {
+        std::size_t p = 1;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    F fn;
+    std::size_t shardMask;
+    std::unique_ptr<Shard[]> shards;
+};
+
+// Argument types given explicitly: needed for lambdas and std::bind results,
+// whose call operator is not a single signature
+template <typename... Args, typename F>
+Memoized<std::decay_t<F>, Args...> memoize(F&& f, std::size_t capacity = 4096, std::size_t shards = 16) {
+    return Memoized<std::decay_t<F>, Args...>(std::forward<F>(f), capacity, shards);
+}
+
+// Plain functions: argument types deduced
+template <typename R, typename... Args>
+Memoized<R(*)(Args...), Args...> memoize(R(*f)(Args...), std::size_t capacity = 4096, std::size_t shards = 16) {
+    return Memoized<R(*)(Args...), Args...>(f, capacity, shards);
+}
+
+// -----------------------------
+// Workload
+// -----------------------------
+// compute() from 05_stdBind_1, made expensive enough to be worth caching
+int compute(int a, int b, int c) {
+    unsigned x = static_cast<unsigned>(a + 2 * b + 3 * c);
+    for (int i = 0; i < 2000; ++i) x = x * 1664525u + 1013904223u;
+    return static_cast<int>(x >> 8);
+}
+
+// Skewed arguments: 90% from a small hot set, the rest from a large cold range
+struct Call {
+    int a, b, c;
+};
+
+std::vector<Call> makeCalls(std::size_t n, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> hot(0, 999), cold(0, 999'999), pick(0, 9);
+    std::vector<Call> calls(n);
+    for (auto& c : calls) {
+        int k = pick(rng) ? hot(rng) : 1000 + cold(rng);
+        c = { k % 100, k / 100, 7 };
+    }
+    return calls;
+}
+
+template <typename Fn>
+double runThreads(int numThreads, const std::vector<std::vector<Call>>& work, Fn& fn, long long& checksum) {
+    std::vector<long long> sums(numThreads);
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&, t] {
+            long long sum = 0;
+            for (const Call& c : work[t]) sum += fn(c.a, c.b, c.c);
+            sums[t] = sum;
+        });
+    }
+    for (auto& th : threads) th.join();
+    auto end = std::chrono::high_resolution_clock::now();
+    checksum = 0;
+    for (long long s : sums) checksum += s;
+    return std::chrono::duration<double>(end - start).count();
+}
+
+void printStats(const char* name, const CacheStats& st) {
+    std::cout << name << ": " << st.hits << " hits, " << st.misses << " misses, " << st.evictions
+        << " evictions (hit rate " << st.hitRate() << " %)\n";
+}
+
+int main() {
+    std::cout << "=== Memoizing functions, lambdas and std::bind results ===\n";
+    auto memoCompute = memoize(compute, 1024);
+    auto boundFunc1 = memoize<int, int>(std::bind(compute, 10, std::placeholders::_1, std::placeholders::_2), 1024);
+    int offset = 3;
+    auto lambda = memoize<int>([offset](int x) { return compute(x, x, offset); }, 1024);
+
+    std::cout << "compute(1, 2, 3) = " << memoCompute(1, 2, 3) << ", again: " << memoCompute(1, 2, 3) << "\n";
+    std::cout << "bind(compute, 10, _1, _2)(5, 2) = " << boundFunc1(5, 2) << " (direct " << compute(10, 5, 2) << ")\n";
+    std::cout << "lambda(4) = " << lambda(4) << ", again: " << lambda(4) << "\n";
+    printStats("compute", memoCompute.stats());
+    printStats("bind   ", boundFunc1.stats());
+    printStats("lambda ", lambda.stats());
+
+    // Bounded: far more distinct keys than capacity, the size never exceeds it
+    auto small = memoize(compute, 250, 16);
+    for (int i = 0; i < 10'000; ++i) small(i, i % 7, 1);
+    std::cout << "10000 distinct keys into capacity 250 over 16 shards: size " << small.size() << ", "
+        << small.stats().evictions << " evictions\n";
+
+    // -----------------------------
+    // Benchmark
+    // -----------------------------
+    const int numThreads = 4;
+    const std::size_t callsPerThread = 200'000;
+    std::vector<std::vector<Call>> work;
+    for (int t = 0; t < numThreads; ++t) work.push_back(makeCalls(callsPerThread, 100 + t));
+
+    auto plain = [](int a, int b, int c) { return compute(a, b, c); };
+    auto oneShard = memoize(compute, 4096, 1);
+    auto sharded = memoize(compute, 4096, 16);
+
+    long long sumPlain = 0, sumOne = 0, sumSharded = 0;
+    double tPlain = runThreads(numThreads, work, plain, sumPlain);
+    double tOne = runThreads(numThreads, work, oneShard, sumOne);
+    double tSharded = runThreads(numThreads, work, sharded, sumSharded);
+
+    double total = double(numThreads) * callsPerThread;
+    std::cout << "\n=== " << numThreads << " threads x " << callsPerThread << " calls, 90% hot keys ===\n";
+    std::cout << "Uncached:           " << tPlain << " s (" << total / tPlain / 1e6 << " M calls/s)\n";
+    std::cout << "memoize, 1 shard:   " << tOne << " s (" << total / tOne / 1e6 << " M calls/s)\n";
+    std::cout << "memoize, 16 shards: " << tSharded << " s (" << total / tSharded / 1e6 << " M calls/s)\n";
+    printStats("1 shard  ", oneShard.stats());
+    printStats("16 shards", sharded.stats());
+    std::cout << "Checksums " << (sumPlain == sumOne && sumOne == sumSharded ? "match" : "DIFFER") << "\n";
+
+    return 0;
+}
@@ -0,0 +1,144 @@
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <algorithm>
+#include <chrono>
+
+// Counter from 07_Functors_1, safe to share between threads:
+// - each thread increments its own stripe, a cache line of its own, so
+//   increments never contend (no cache line ping-pong between cores)
+// - count() sums the stripes; it is exact once the writers are done and a
+//   consistent-enough snapshot while they run
+// - quiet by default: printing on every call would serialize all callers on cout
+class Counter
+{
+public:
+    enum class Mode { Quiet, Verbose };
+
+    explicit Counter(Mode m = Mode::Quiet, unsigned stripeCount = std::thread::hardware_concurrency())
+        : mode(m), mask(roundUpPow2(std::max(stripeCount, 1u)) - 1), stripes(new Stripe[mask + 1]) {}
+
+    // Counts the call and passes the value through. The 07 version returned
+    // value + count, but that needs the global count on every call, which is
+    // exactly the shared atomic this class avoids.
+    int operator()(int value)
+    {
+        unsigned s = threadIndex() & mask;
+        long long local = stripes[s].count.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (mode == Mode::Verbose) {
+            std::lock_guard<std::mutex> lock(printMutex);
+            std::cout << "Stripe " << s << " call #" << local << ": adding " << value << "\n";
+        }
+        return value;
+    }
+
+    long long count() const
+    {
+        long long total = 0;
+        for (unsigned i = 0; i <= mask; ++i) total += stripes[i].count.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    unsigned stripeCount() const { return mask + 1; }
+
+private:
+    struct alignas(64) Stripe
+    {
+        std::atomic<long long> count{ 0 };
+    };
+
+    static constexpr unsigned NoIndex = ~0u;
+
+    // Threads get consecutive indices from a process-wide counter on first
+    // use; the index is masked to a stripe, so once more threads than
+    // stripes have counted (in any Counter), threads share stripes
+    static unsigned threadIndex()
+    {
+        static std::atomic<unsigned> next{ 0 };
+        thread_local unsigned index = NoIndex; // constant-initialized: no guard on the hot path
+        if (index == NoIndex) index = next.fetch_add(1, std::memory_order_relaxed);
+        return index;
+    }
+
+    static unsigned roundUpPow2(unsigned n)
+    {
+        unsigned p = 1;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    Mode mode;
+    unsigned mask;
+    std::unique_ptr<Stripe[]> stripes;
+    std::mutex printMutex;
+};
+
+// The straightforward alternative: every thread hits the same atomic
+class SharedAtomicCounter
+{
+public:
+    int operator()(int value)
+    {
+        count.fetch_add(1, std::memory_order_relaxed);
+        return value;
+    }
+
+    long long total() const { return count.load(); }
+
+private:
+    std::atomic<long long> count{ 0 };
+};
+
+template <typename F>
+double runThreads(int numThreads, int callsPerThread, F& counter)
+{
+    std::vector<std::thread> threads;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&counter, callsPerThread, t] {
+            for (int i = 0; i < callsPerThread; ++i) counter(i + t);
+        });
+    }
+    for (auto& th : threads) th.join();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+int main()
+{
+    std::cout << "=== Verbose mode, as in 07_Functors_1 ===\n";
+    Counter verbose(Counter::Mode::Verbose);
+    int result1 = verbose(5);
+    int result2 = verbose(5);
+    int result3 = verbose(10);
+    std::cout << "Results: " << result1 << ", " << result2 << ", " << result3
+        << " (count " << verbose.count() << ")\n";
+
+    // -----------------------------
+    // Scaling: 1..N threads, striped vs one shared atomic
+    // -----------------------------
+    const int callsPerThread = 10'000'000;
+    int maxThreads = static_cast<int>(std::max(std::thread::hardware_concurrency(), 4u));
+
+    std::cout << "\n=== " << callsPerThread << " calls per thread (" << std::thread::hardware_concurrency()
+        << " hardware threads) ===\n";
+    std::cout << "threads   std::atomic<long long>   striped Counter   speedup\n";
+    bool allExact = true;
+    for (int n = 1; n <= maxThreads; n *= 2) {
+        SharedAtomicCounter shared;
+        Counter striped(Counter::Mode::Quiet, static_cast<unsigned>(maxThreads));
+        double tShared = runThreads(n, callsPerThread, shared);
+        double tStriped = runThreads(n, callsPerThread, striped);
+        long long expected = static_cast<long long>(n) * callsPerThread;
+        allExact = allExact && shared.total() == expected && striped.count() == expected;
+
+        std::cout << "  " << n << "\t  " << expected / tShared / 1e6 << " M/s\t             "
+            << expected / tStriped / 1e6 << " M/s\t   x" << tShared / tStriped << "\n";
+    }
+    std::cout << "Counts " << (allExact ? "exact" : "WRONG") << "\n";
+
+    return 0;
+}
@@ -0,0 +1,190 @@
+#include <iostream>
+#include <vector>
+#include <functional>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <utility>
+#include <stdexcept>
+#include <chrono>
+
+#if defined(_MSC_VER)
+#define NOINLINE __declspec(noinline)
+#else
+#define NOINLINE __attribute__((noinline))
+#endif
+
+// -----------------------------
+// Global new/delete overrides: count instead of printing
+// -----------------------------
+static std::size_t g_allocations = 0;
+static std::size_t g_bytes = 0;
+
+void* operator new(std::size_t n) noexcept(false) {
+    if (n == 0) n = 1;
+    void* p = std::malloc(n);
+    if (!p) throw std::bad_alloc();
+    ++g_allocations;
+    g_bytes += n;
+    return p;
+}
+
+// Not inlined: g++ would otherwise see free() paired with a new-expression
+// at every call site and warn (-Wmismatched-new-delete)
+NOINLINE void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+NOINLINE void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+struct AllocationScope {
+    std::size_t allocations = g_allocations;
+    std::size_t bytes = g_bytes;
+
+    std::size_t newAllocations() const { return g_allocations - allocations; }
+    std::size_t newBytes() const { return g_bytes - bytes; }
+};
+
+// -----------------------------
+// cow_capture<T>: copies share one immutable value
+// -----------------------------
+// Copying costs one atomic increment and no allocation. Reading never
+// copies. write() clones the value first if anyone else still shares it,
+// so a mutation is never visible through another copy. A moved-from
+// cow_capture is empty: it can be copied, assigned or destroyed, and
+// reading or writing through it throws std::logic_error.
+template <typename T>
+class cow_capture {
+public:
+    explicit cow_capture(T value) : block(new Block{ std::move(value) }) {}
+
+    cow_capture(const cow_capture& other) noexcept : block(other.block) { retain(); }
+    cow_capture(cow_capture&& other) noexcept : block(std::exchange(other.block, nullptr)) {}
+
+    cow_capture& operator=(cow_capture other) noexcept {
+        std::swap(block, other.block);
+        return *this;
+    }
+
+    ~cow_capture() { release(); }
+
+    const T& get() const { return checked()->value; }
+    const T& operator*() const { return checked()->value; }
+    const T* operator->() const { return &checked()->value; }
+
+    // Mutable access: the clone happens here, at most once per shared value
+    T& write() {
+        if (checked()->refs.load(std::memory_order_acquire) != 1) {
+            Block* copy = new Block{ block->value };
+            release();
+            block = copy;
+        }
+        return block->value;
+    }
+
+    bool shared() const { return block && block->refs.load(std::memory_order_acquire) != 1; }
+    bool empty() const { return block == nullptr; }
+
+private:
+    struct Block {
+        T value;
+        std::atomic<long> refs{ 1 };
+    };
+
+    Block* checked() const {
+        if (!block) throw std::logic_error("cow_capture: access through a moved-from capture");
+        return block;
+    }
+
+    void retain() {
+        if (block) block->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void release() {
+        if (block && block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) delete block;
+    }
+
+    Block* block;
+};
+
+template <typename T>
+cow_capture<std::decay_t<T>> make_cow(T&& value) {
+    return cow_capture<std::decay_t<T>>(std::forward<T>(value));
+}
+
+long long sumOf(const std::vector<int>& v) {
+    long long s = 0;
+    for (int x : v) s += x;
+    return s;
+}
+
+int main() {
+    std::cout << "=== 5) from 08_Lambdas_1, with a shared capture ===\n";
+    std::vector<int> vec = { 1, 2, 3, 4, 5 };
+    auto lambdaWithInit = [myVec = make_cow(vec)]() {
+        std::cout << "Inside lambda, myVec: ";
+        for (int v : *myVec) std::cout << v << " ";
+        std::cout << "\n";
+        };
+    lambdaWithInit(); // prints a copy of vec
+    vec.push_back(6); // modifying vec outside does not affect myVec
+    lambdaWithInit(); // still prints original {1,2,3,4,5}
+
+    std::cout << "\n=== Mutation clones only the mutating copy ===\n";
+    auto appender = [myVec = make_cow(vec)](int v) mutable {
+        myVec.write().push_back(v);
+        return myVec->size();
+        };
+    auto copy = appender;
+    std::cout << "copy(7) -> size " << copy(7) << ", copy(8) -> size " << copy(8) << " (cloned once)\n";
+    std::cout << "original(9) -> size " << appender(9) << " (its own value, still 6 + 1)\n";
+
+    auto source = make_cow(vec);
+    auto taken = std::move(source);
+    auto copyOfEmpty = source; // copying a moved-from capture is fine; reading it throws
+    std::cout << "Moved-from capture is empty: " << std::boolalpha << copyOfEmpty.empty()
+        << ", new owner holds " << taken->size() << " values\n" << std::noboolalpha;
+
+    // -----------------------------
+    // Copying lambdas into std::function containers
+    // -----------------------------
+    const int copies = 1000;
+    std::vector<int> big(10'000, 1);
+
+    auto deep = [myVec = big]() { return sumOf(myVec); };
+    auto cow = [myVec = make_cow(big)]() { return sumOf(*myVec); };
+
+    std::vector<std::function<long long()>> deepQueue, cowQueue;
+    deepQueue.reserve(copies);
+    cowQueue.reserve(copies);
+
+    AllocationScope deepScope;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < copies; ++i) deepQueue.push_back(deep);
+    std::vector<std::function<long long()>> deepCopy = deepQueue; // e.g. fanning out to another queue
+    auto end = std::chrono::high_resolution_clock::now();
+    std::size_t deepAllocs = deepScope.newAllocations(), deepBytes = deepScope.newBytes();
+    double tDeep = std::chrono::duration<double>(end - start).count();
+
+    AllocationScope cowScope;
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < copies; ++i) cowQueue.push_back(cow);
+    std::vector<std::function<long long()>> cowCopy = cowQueue;
+    end = std::chrono::high_resolution_clock::now();
+    std::size_t cowAllocs = cowScope.newAllocations(), cowBytes = cowScope.newBytes();
+    double tCow = std::chrono::duration<double>(end - start).count();
+
+    long long deepSum = 0, cowSum = 0;
+    for (auto& f : deepCopy) deepSum += f();
+    for (auto& f : cowCopy) cowSum += f();
+
+    std::cout << "\n=== " << copies << " lambdas capturing " << big.size() << " ints, queued twice ===\n";
+    std::cout << "[myVec = vec]:           " << deepAllocs << " allocations, " << deepBytes / 1024 << " KiB, " << tDeep * 1e3 << " ms\n";
+    std::cout << "[myVec = make_cow(vec)]: " << cowAllocs << " allocations, " << cowBytes / 1024 << " KiB, " << tCow * 1e3 << " ms\n";
+    std::cout << "(the remaining allocations are the std::function targets themselves and the copied queue)\n";
+    std::cout << "Results " << (deepSum == cowSum ? "match" : "DIFFER") << "\n";
+
+    return 0;
+}
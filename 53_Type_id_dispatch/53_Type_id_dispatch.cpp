@@ -0,0 +1,282 @@
+// -----------------------------
+// Type IDs without RTTI, and O(1) dispatch by type
+// -----------------------------
+// Builds with -fno-rtti (or /GR-); the std::type_index comparison is then
+// left out.
+// - type_name<T>()  : readable name at compile time, a typeid(T).name() substitute
+// - type_key<T>     : unique per type, a compile-time constant (an address)
+// - type_id<T>()    : dense 0, 1, 2, ... per type, usable as an array index
+// - TypeSet<Ts...>  : dense IDs fixed at compile time for a known set of types
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <chrono>
+
+#if defined(__GXX_RTTI) || defined(_CPPRTTI)
+#define HAS_RTTI 1
+#include <typeindex>
+#include <unordered_map>
+#else
+#define HAS_RTTI 0
+#endif
+
+namespace tid {
+
+// -----------------------------
+// Names
+// -----------------------------
+template <typename T>
+constexpr std::string_view rawName() {
+#if defined(_MSC_VER)
+    return __FUNCSIG__;
+#else
+    return __PRETTY_FUNCTION__;
+#endif
+}
+
+// Where the type sits in the signature string, measured once on a known type
+inline constexpr std::size_t namePrefix = rawName<int>().find("int");
+inline constexpr std::size_t nameSuffix = rawName<int>().size() - namePrefix - 3;
+
+template <typename T>
+constexpr std::string_view type_name() {
+    constexpr std::string_view raw = rawName<T>();
+    return raw.substr(namePrefix, raw.size() - namePrefix - nameSuffix);
+}
+
+// -----------------------------
+// Unique keys and dense IDs
+// -----------------------------
+template <typename T>
+struct KeyTag {
+    static constexpr char tag = 0;
+};
+
+using TypeKey = const void*;
+
+template <typename T>
+inline constexpr TypeKey type_key = &KeyTag<std::remove_cvref_t<T>>::tag;
+
+using TypeId = std::uint32_t;
+
+inline TypeId nextTypeId() {
+    static std::atomic<TypeId> next{ 0 };
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Assigned on first use, once per type (thread-safe static initialization),
+// so IDs stay dense: 0 .. number of types used - 1
+template <typename T>
+TypeId denseId() {
+    static const TypeId id = nextTypeId();
+    return id;
+}
+
+template <typename T>
+TypeId type_id() {
+    return denseId<std::remove_cvref_t<T>>();
+}
+
+// Compile-time dense IDs when the full set of types is known up front
+template <typename... Ts>
+struct TypeSet {
+    static constexpr std::size_t size = sizeof...(Ts);
+
+    template <typename T>
+    static constexpr TypeId id() {
+        constexpr bool matches[] = { std::is_same_v<T, Ts>... };
+        for (std::size_t i = 0; i < size; ++i)
+            if (matches[i]) return static_cast<TypeId>(i);
+        throw "type is not in this TypeSet"; // compile error when used in a constant expression
+    }
+};
+
+} // namespace tid
+
+// -----------------------------
+// Type-erased message and handlers
+// -----------------------------
+struct Message {
+    tid::TypeId type;
+    const void* data;
+};
+
+template <typename T>
+Message makeMessage(const T& value) {
+    return { tid::type_id<T>(), &value };
+}
+
+struct Handler {
+    void (*call)(void* state, const void* message) = nullptr;
+    void* state = nullptr;
+
+    void operator()(const void* message) const { call(state, message); }
+};
+
+// Wraps a handler for messages of type T; `owners` keeps its state alive
+template <typename T, typename F>
+Handler makeHandler(F f, std::vector<std::shared_ptr<void>>& owners) {
+    auto holder = std::make_shared<F>(std::move(f));
+    owners.push_back(holder);
+    return { [](void* s, const void* m) { (*static_cast<F*>(s))(*static_cast<const T*>(m)); }, holder.get() };
+}
+
+// Flat table: the type ID is the index, so dispatch is one load and one call
+class HandlerTable {
+public:
+    template <typename T, typename F>
+    void on(F f) {
+        Handler h = makeHandler<T>(std::move(f), owners);
+        tid::TypeId id = tid::type_id<T>();
+        if (id >= table.size()) table.resize(id + 1);
+        table[id] = h;
+    }
+
+    bool dispatch(const Message& m) const {
+        if (m.type >= table.size() || !table[m.type].call) return false;
+        table[m.type](m.data);
+        return true;
+    }
+
+    template <typename T>
+    bool dispatch(const T& value) const { return dispatch(makeMessage(value)); }
+
+private:
+    std::vector<Handler> table;
+    std::vector<std::shared_ptr<void>> owners;
+};
+
+#if HAS_RTTI
+// The usual alternative, same handlers, keyed by std::type_index
+class TypeIndexTable {
+public:
+    template <typename T, typename F>
+    void on(F f) { map[std::type_index(typeid(T))] = makeHandler<T>(std::move(f), owners); }
+
+    bool dispatch(const std::type_index& type, const void* data) const {
+        auto it = map.find(type);
+        if (it == map.end()) return false;
+        it->second(data);
+        return true;
+    }
+
+private:
+    std::unordered_map<std::type_index, Handler> map;
+    std::vector<std::shared_ptr<void>> owners;
+};
+#endif
+
+// -----------------------------
+// Messages
+// -----------------------------
+struct Add { int a, b; };
+struct Sub { int a, b; };
+struct Mul { int a, b; };
+struct Divide { int a, b; };
+struct Negate { int a; };
+struct Square { int a; };
+struct Reset {};
+struct Tick { long long time; };
+
+using Calculator = tid::TypeSet<Add, Sub, Mul, Divide>;
+static_assert(Calculator::id<Add>() == 0 && Calculator::id<Divide>() == 3);
+static_assert(tid::type_key<const Add&> == tid::type_key<Add>);
+static_assert(tid::type_name<Add>().ends_with("Add")); // MSVC spells it "struct Add"
+
+int main() {
+    std::cout << "=== Type names and IDs without typeid ===\n";
+    auto lambda1 = [](int x) { return x + 1; };
+    auto lambda2 = [](int x) { return x + 1; };
+    std::cout << "lambda1: " << tid::type_name<decltype(lambda1)>() << " id " << tid::type_id<decltype(lambda1)>() << "\n";
+    std::cout << "lambda2: " << tid::type_name<decltype(lambda2)>() << " id " << tid::type_id<decltype(lambda2)>() << "\n";
+    std::cout << "int:     " << tid::type_name<int>() << " id " << tid::type_id<int>() << "\n";
+    std::cout << "lambda1 again: id " << tid::type_id<decltype(lambda1)>() << " (stable)\n";
+    std::cout << "TypeSet<Add, Sub, Mul, Divide>::id<Mul>() = " << Calculator::id<Mul>() << " (compile time)\n";
+    // Checked here, not in a static_assert: comparing the addresses of two
+    // different variables is not a constant expression under every compiler mode
+    std::cout << "type_key<Add> != type_key<Sub>: " << std::boolalpha << (tid::type_key<Add> != tid::type_key<Sub>)
+        << std::noboolalpha << "\n";
+
+    long long acc = 0;
+    HandlerTable handlers;
+    handlers.on<Add>([&](const Add& m) { acc += m.a + m.b; });
+    handlers.on<Sub>([&](const Sub& m) { acc += m.a - m.b; });
+    handlers.on<Mul>([&](const Mul& m) { acc += m.a * m.b; });
+    handlers.on<Divide>([&](const Divide& m) { acc += m.b ? m.a / m.b : 0; });
+    handlers.on<Negate>([&](const Negate& m) { acc -= m.a; });
+    handlers.on<Square>([&](const Square& m) { acc += m.a * m.a; });
+    handlers.on<Reset>([&](const Reset&) { acc = 0; });
+    handlers.on<Tick>([&](const Tick& m) { acc += m.time & 1; });
+
+    handlers.dispatch(Add{ 10, 5 });
+    handlers.dispatch(Mul{ 3, 4 });
+    std::cout << "\nAdd{10, 5} then Mul{3, 4}: acc = " << acc << "\n";
+    std::cout << "Unregistered type handled? " << (handlers.dispatch(3.5) ? "yes" : "no") << "\n";
+
+    // -----------------------------
+    // Benchmark: random message stream
+    // -----------------------------
+    const std::size_t N = 1 << 16;
+    const int repeats = 200;
+    Add add{ 1, 2 }; Sub sub{ 5, 3 }; Mul mul{ 2, 3 }; Divide div{ 9, 3 };
+    Negate neg{ 4 }; Square sq{ 3 }; Tick tick{ 7 };
+    Message samples[] = { makeMessage(add), makeMessage(sub), makeMessage(mul), makeMessage(div),
+                          makeMessage(neg), makeMessage(sq), makeMessage(tick) };
+
+    std::mt19937 rng(5);
+    std::vector<Message> stream(N);
+    for (auto& m : stream) m = samples[rng() % std::size(samples)];
+
+    acc = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < repeats; ++r)
+        for (const Message& m : stream) handlers.dispatch(m);
+    auto end = std::chrono::high_resolution_clock::now();
+    double tFlat = std::chrono::duration<double>(end - start).count();
+    long long flatAcc = acc;
+
+    double total = double(N) * repeats;
+    std::cout << "\n=== " << N << " messages x " << repeats << " ===\n";
+    std::cout << "Flat table by type_id:         " << tFlat / total * 1e9 << " ns/dispatch\n";
+
+#if HAS_RTTI
+    TypeIndexTable byIndex;
+    byIndex.on<Add>([&](const Add& m) { acc += m.a + m.b; });
+    byIndex.on<Sub>([&](const Sub& m) { acc += m.a - m.b; });
+    byIndex.on<Mul>([&](const Mul& m) { acc += m.a * m.b; });
+    byIndex.on<Divide>([&](const Divide& m) { acc += m.b ? m.a / m.b : 0; });
+    byIndex.on<Negate>([&](const Negate& m) { acc -= m.a; });
+    byIndex.on<Square>([&](const Square& m) { acc += m.a * m.a; });
+    byIndex.on<Tick>([&](const Tick& m) { acc += m.time & 1; });
+
+    struct Tagged { std::type_index type; const void* data; };
+    const Tagged tagged[] = { { typeid(Add), &add }, { typeid(Sub), &sub }, { typeid(Mul), &mul },
+                              { typeid(Divide), &div }, { typeid(Negate), &neg }, { typeid(Square), &sq },
+                              { typeid(Tick), &tick } };
+    std::vector<Tagged> taggedStream;
+    taggedStream.reserve(N);
+    for (const Message& m : stream) {
+        for (std::size_t k = 0; k < std::size(samples); ++k)
+            if (samples[k].type == m.type) taggedStream.push_back(tagged[k]);
+    }
+
+    acc = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < repeats; ++r)
+        for (const Tagged& m : taggedStream) byIndex.dispatch(m.type, m.data);
+    end = std::chrono::high_resolution_clock::now();
+    double tMap = std::chrono::duration<double>(end - start).count();
+
+    std::cout << "unordered_map<type_index>:     " << tMap / total * 1e9 << " ns/dispatch (x" << tMap / tFlat << ")\n";
+    std::cout << "Results " << (acc == flatAcc ? "match" : "DIFFER") << "\n";
+#else
+    std::cout << "(built without RTTI: std::type_index comparison skipped, acc = " << flatAcc << ")\n";
+#endif
+
+    return 0;
+}
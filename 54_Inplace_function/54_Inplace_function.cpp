@@ -0,0 +1,296 @@
+// -----------------------------
+// inplace_function: std::function without the heap
+// -----------------------------
+// The callable is always stored inside the object, in a buffer of Capacity
+// bytes aligned to Align. A callable that does not fit is a compile error
+// (not a silent heap allocation), so the cost is visible where it is chosen.
+//     inplace_function<Sig, Capacity, Align>       copyable, like std::function
+//     inplace_move_function<Sig, Capacity, Align>  move-only: also accepts
+//                                                  move-only callables
+#include <iostream>
+#include <vector>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <new>
+#include <cstdlib>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+// -----------------------------
+// Global new/delete overrides: count instead of printing
+// -----------------------------
+static std::size_t g_allocations = 0;
+
+void* operator new(std::size_t n) noexcept(false) {
+    if (n == 0) n = 1;
+    void* p = std::malloc(n);
+    if (!p) throw std::bad_alloc();
+    ++g_allocations;
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+// -----------------------------
+// Implementation
+// -----------------------------
+namespace detail {
+
+template <typename R, typename... Args>
+struct InplaceOps {
+    R (*invoke)(void* obj, Args&&... args);
+    void (*copy)(void* dst, const void* src);       // nullptr for move-only storage
+    void (*move)(void* dst, void* src) noexcept;    // move-construct dst, destroy src
+    void (*destroy)(void* obj) noexcept;
+};
+
+template <typename F, typename R, typename... Args>
+R invokeThunk(void* obj, Args&&... args) {
+    return std::invoke(*static_cast<F*>(obj), std::forward<Args>(args)...);
+}
+
+template <typename F>
+void copyThunk(void* dst, const void* src) {
+    ::new (dst) F(*static_cast<const F*>(src));
+}
+
+template <typename F>
+void moveThunk(void* dst, void* src) noexcept {
+    ::new (dst) F(std::move(*static_cast<F*>(src)));
+    static_cast<F*>(src)->~F();
+}
+
+template <typename F>
+void destroyThunk(void* obj) noexcept {
+    static_cast<F*>(obj)->~F();
+}
+
+// One table per stored type; copy is only instantiated for copyable storage
+template <typename F, bool Copyable, typename R, typename... Args>
+inline constexpr InplaceOps<R, Args...> opsFor = {
+    &invokeThunk<F, R, Args...>,
+    [] { if constexpr (Copyable) return &copyThunk<F>; else return nullptr; }(),
+    &moveThunk<F>,
+    &destroyThunk<F>,
+};
+
+template <typename Sig, std::size_t Capacity, std::size_t Align, bool Copyable>
+class InplaceFunction;
+
+template <typename R, typename... Args, std::size_t Capacity, std::size_t Align, bool Copyable>
+class InplaceFunction<R(Args...), Capacity, Align, Copyable> {
+public:
+    // True when F can be stored: checked by the constructor with a readable message
+    template <typename F>
+    static constexpr bool fits = sizeof(F) <= Capacity && Align % alignof(F) == 0
+        && std::is_nothrow_move_constructible_v<F> && (!Copyable || std::is_copy_constructible_v<F>);
+
+    InplaceFunction() noexcept = default;
+    InplaceFunction(std::nullptr_t) noexcept {}
+
+    template <typename F, typename D = std::decay_t<F>>
+        requires (!std::is_same_v<D, InplaceFunction>) && std::is_invocable_r_v<R, D&, Args...>
+    InplaceFunction(F&& f) {
+        static_assert(sizeof(D) <= Capacity, "callable too large for this inplace_function: increase Capacity");
+        static_assert(Align % alignof(D) == 0, "callable over-aligned for this inplace_function: increase Align");
+        static_assert(std::is_nothrow_move_constructible_v<D>, "inplace_function needs a nothrow-movable callable");
+        static_assert(!Copyable || std::is_copy_constructible_v<D>, "move-only callable: use inplace_move_function");
+        ::new (static_cast<void*>(storage)) D(std::forward<F>(f));
+        ops = &opsFor<D, Copyable, R, Args...>;
+    }
+
+    InplaceFunction(const InplaceFunction& other) requires Copyable : ops(other.ops) {
+        if (ops) ops->copy(storage, other.storage);
+    }
+
+    InplaceFunction(InplaceFunction&& other) noexcept : ops(other.ops) {
+        if (ops) ops->move(storage, other.storage);
+        other.ops = nullptr;
+    }
+
+    InplaceFunction& operator=(const InplaceFunction& other) requires Copyable {
+        if (this != &other) {
+            InplaceFunction tmp(other);
+            *this = std::move(tmp);
+        }
+        return *this;
+    }
+
+    InplaceFunction& operator=(InplaceFunction&& other) noexcept {
+        if (this != &other) {
+            reset();
+            if (other.ops) other.ops->move(storage, other.storage);
+            ops = std::exchange(other.ops, nullptr);
+        }
+        return *this;
+    }
+
+    ~InplaceFunction() { reset(); }
+
+    // const like std::function::operator(): the stored callable may still be stateful
+    R operator()(Args... args) const {
+        if (!ops) throw std::bad_function_call();
+        return ops->invoke(storage, std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const noexcept { return ops != nullptr; }
+
+    void reset() noexcept {
+        if (ops) ops->destroy(storage);
+        ops = nullptr;
+    }
+
+private:
+    const InplaceOps<R, Args...>* ops = nullptr;
+    alignas(Align) mutable std::byte storage[Capacity];
+};
+
+} // namespace detail
+
+template <typename Sig, std::size_t Capacity = 32, std::size_t Align = alignof(std::max_align_t)>
+using inplace_function = detail::InplaceFunction<Sig, Capacity, Align, true>;
+
+template <typename Sig, std::size_t Capacity = 32, std::size_t Align = alignof(std::max_align_t)>
+using inplace_move_function = detail::InplaceFunction<Sig, Capacity, Align, false>;
+
+// -----------------------------
+// Callables from 10_stdFunction_1 and 11_stdFunction_2
+// -----------------------------
+int freeFunction(int x) { return x * 2; }
+int addXY(int x, int y) { return x + y; }
+
+struct Multiply {
+    int factor;
+    Multiply(int f) : factor(f) {}
+    int operator()(int x) const { return x * factor; }
+};
+
+class Calculator {
+private:
+    int id;
+public:
+    Calculator(int i) : id(i) {}
+    int getId() const { return id; }
+    int add(int x, int y) const { return x + y; }
+};
+
+struct Logger {
+    std::string prefix;
+    Logger(const std::string& p) : prefix(p) {}
+    // string_view instead of 11's const std::string&: binding a string literal
+    // would otherwise build (and allocate) a temporary string on every call
+    void operator()(std::string_view message) const { std::cout << prefix << message << "\n"; }
+};
+
+class Worker {
+private:
+    int id;
+public:
+    Worker(int i) : id(i) {}
+    void processTask(int value) const {
+        std::cout << "[Worker " << id << "] Processing value: " << value << ", squared = " << value * value << "\n";
+    }
+};
+
+void printSum(int x, int y) { std::cout << "[Free function] Sum = " << x + y << "\n"; }
+
+// Compile-time checks: what fits where
+struct Big { char data[64]; void operator()() const {} };
+static_assert(inplace_function<void(), 64>::fits<Big>);
+static_assert(!inplace_function<void(), 32>::fits<Big>);
+struct MoveOnly { std::unique_ptr<int> p; void operator()() const {} };
+static_assert(!inplace_function<void()>::fits<MoveOnly>);
+static_assert(inplace_move_function<void()>::fits<MoveOnly>);
+// inplace_function<void(), 32> tooBig = Big{}; // error: callable too large for this inplace_function
+
+// Runs the event loop of 11_stdFunction_2 with the given queue type
+template <typename Queue>
+int runEventLoop(Queue& eventQueue) {
+    int counter = 0;
+
+    eventQueue.push_back([&eventQueue]() {
+        std::cout << "[Lambda] scheduling a new task dynamically\n";
+        eventQueue.push_back([]() {
+            std::cout << "[Dynamically added lambda] Hello from dynamically scheduled task!\n";
+            });
+        });
+
+    Logger logger("Logger: ");
+    eventQueue.push_back(std::bind(logger, "Initial log event"));
+    eventQueue.push_back(std::bind(printSum, 3, 4));
+
+    Worker w1(1);
+    Worker w2(2);
+    eventQueue.push_back(std::bind(&Worker::processTask, &w1, 5));
+    eventQueue.push_back(std::bind(&Worker::processTask, &w2, 8));
+
+    eventQueue.push_back([&counter]() {
+        counter += 10;
+        std::cout << "[Lambda reference] counter = " << counter << "\n";
+        });
+
+    size_t i = 0;
+    while (i < eventQueue.size()) {
+        eventQueue[i]();
+        ++i;
+    }
+    return counter;
+}
+
+int main() {
+    std::cout << "=== Heterogeneous callables from 10_stdFunction_1 ===\n";
+    std::vector<inplace_function<int(int), 32>> funcs;
+    int capturedValue = 5;
+    Calculator calc1(101);
+    int externalValue = 100;
+
+    funcs.push_back([](int x) { return x + 1; });
+    funcs.push_back([capturedValue](int x) mutable { return x + ++capturedValue; });
+    funcs.push_back(Multiply(3));
+    funcs.push_back(&freeFunction);
+    funcs.push_back(std::bind(freeFunction, std::placeholders::_1));
+    funcs.push_back(std::bind(addXY, std::placeholders::_1, 5));
+    funcs.push_back(std::bind(&Calculator::add, &calc1, std::placeholders::_1, 10));
+    funcs.push_back([&externalValue](int x) { externalValue += x; return x + externalValue; });
+
+    for (size_t i = 0; i < funcs.size(); ++i) std::cout << "funcs[" << i << "](10) = " << funcs[i](10) << "\n";
+    std::cout << "stateful lambda again: " << funcs[1](10) << " (state kept in place)\n";
+
+    inplace_move_function<int(), 32> owning = [p = std::make_unique<int>(42)]() { return *p; };
+    inplace_move_function<int(), 32> moved = std::move(owning);
+    std::cout << "move-only capture: " << moved() << ", moved-from is " << (owning ? "set" : "empty") << "\n";
+
+    // -----------------------------
+    // Event queue: zero heap allocations
+    // -----------------------------
+    std::cout << "\n=== Event loop of 11_stdFunction_2 with inplace_function<void(), 48> ===\n";
+    std::vector<inplace_function<void(), 48>> inplaceQueue;
+    inplaceQueue.reserve(16); // the queue itself is the only allocation, made up front
+    std::size_t before = g_allocations;
+    int counter = runEventLoop(inplaceQueue);
+    std::size_t inplaceAllocs = g_allocations - before;
+
+    std::cout << "\n=== Same loop with std::function<void()> ===\n";
+    std::vector<std::function<void()>> stdQueue;
+    stdQueue.reserve(16);
+    before = g_allocations;
+    runEventLoop(stdQueue);
+    std::size_t stdAllocs = g_allocations - before;
+
+    std::cout << "\nFinal counter value = " << counter << "\n";
+    std::cout << "Heap allocations while queueing and running 7 tasks: inplace_function " << inplaceAllocs
+        << (inplaceAllocs == 0 ? " (OK)" : " (UNEXPECTED)") << ", std::function " << stdAllocs << "\n";
+    std::cout << "sizeof: inplace_function<void(), 48> " << sizeof(inplace_function<void(), 48>)
+        << ", std::function<void()> " << sizeof(std::function<void()>) << "\n";
+
+    return inplaceAllocs == 0 ? 0 : 1;
+}
@@ -0,0 +1,275 @@
+// -----------------------------
+// Poly collection: callables grouped by concrete type
+// -----------------------------
+// vector<std::function> stores every callable behind its own indirect call,
+// and a mixed sequence makes each of those calls hard to predict.
+// PolyCollection keeps one contiguous segment per concrete type instead:
+// - invoke_all()      one virtual call per segment, then a plain loop of
+//                     direct (inlinable) calls; results come out segment by
+//                     segment, so use it when order does not matter
+// - for_each<Ts...>() the same for any visitor, for the listed types; other
+//                     segments fall back to one std::function call per element
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <stdexcept>
+#include <span>
+#include <random>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+template <typename Sig>
+class PolyCollection;
+
+template <typename R, typename... A>
+class PolyCollection<R(A...)> {
+public:
+    template <typename F>
+    void insert(F f) {
+        segmentFor<F>().items.push_back(std::move(f));
+        ++count;
+    }
+
+    std::size_t size() const { return count; }
+    std::size_t segmentCount() const { return segments.size(); }
+
+    // out must hold size() results; written segment by segment
+    void invoke_all(std::span<R> out, const A&... args) {
+        if (out.size() < count) throw std::invalid_argument("PolyCollection::invoke_all: output too small");
+        std::size_t pos = 0;
+        for (auto& s : segments) pos += s.segment->invokeEach(out.subspan(pos), args...);
+    }
+
+    // Visitor gets each callable as its real type when it is one of Ts...,
+    // otherwise as a reference wrapper with the erased signature
+    template <typename... Ts, typename V>
+    void for_each(V visit) {
+        for (auto& s : segments) {
+            bool done = (visitAs<Ts>(s, visit) || ...);
+            if (!done) s.segment->forEachErased([&](const std::function<R(A...)>& f) { visit(f); });
+        }
+    }
+
+private:
+    struct SegmentBase {
+        virtual ~SegmentBase() = default;
+        virtual std::size_t invokeEach(std::span<R> out, const A&... args) = 0;
+        virtual void forEachErased(const std::function<void(const std::function<R(A...)>&)>& visit) = 0;
+    };
+
+    template <typename F>
+    struct Segment : SegmentBase {
+        std::vector<F> items;
+
+        // The loop the whole design is for: F is known, so calls are direct
+        std::size_t invokeEach(std::span<R> out, const A&... args) override {
+            const std::size_t n = items.size();
+            F* f = items.data();
+            for (std::size_t i = 0; i < n; ++i) out[i] = f[i](args...);
+            return n;
+        }
+
+        void forEachErased(const std::function<void(const std::function<R(A...)>&)>& visit) override {
+            for (F& f : items) visit(std::function<R(A...)>(std::ref(f)));
+        }
+    };
+
+    template <typename T>
+    struct TypeTag {
+        static constexpr char tag = 0;
+    };
+
+    struct Entry {
+        const void* type;
+        std::unique_ptr<SegmentBase> segment;
+    };
+
+    template <typename F>
+    Segment<F>& segmentFor() {
+        const void* key = &TypeTag<F>::tag;
+        for (auto& e : segments)
+            if (e.type == key) return static_cast<Segment<F>&>(*e.segment);
+        segments.push_back({ key, std::make_unique<Segment<F>>() });
+        return static_cast<Segment<F>&>(*segments.back().segment);
+    }
+
+    template <typename T, typename V>
+    static bool visitAs(Entry& e, V& visit) {
+        if (e.type != &TypeTag<T>::tag) return false;
+        for (T& f : static_cast<Segment<T>&>(*e.segment).items) visit(f);
+        return true;
+    }
+
+    std::vector<Entry> segments;
+    std::size_t count = 0;
+};
+
+// -----------------------------
+// Branch-miss counter (Linux only; n/a elsewhere or when not permitted)
+// -----------------------------
+class BranchMissCounter {
+public:
+    BranchMissCounter() {
+#if defined(__linux__)
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    ~BranchMissCounter() {
+#if defined(__linux__)
+        if (fd >= 0) close(fd);
+#endif
+    }
+
+    bool available() const { return fd >= 0; }
+
+    void start() {
+#if defined(__linux__)
+        if (fd < 0) return;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    std::uint64_t stop() {
+        std::uint64_t v = 0;
+#if defined(__linux__)
+        if (fd < 0) return 0;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd, &v, sizeof(v)) != sizeof(v)) v = 0;
+#endif
+        return v;
+    }
+
+private:
+    int fd = -1;
+};
+
+// -----------------------------
+// The callables of 10_stdFunction_1 (without printing)
+// -----------------------------
+int freeFunction(int x) { return x * 2; }
+int addXY(int x, int y) { return x + y; }
+
+struct Multiply {
+    int factor;
+    Multiply(int f) : factor(f) {}
+    int operator()(int x) const { return x * factor; }
+};
+
+class Calculator {
+private:
+    int id;
+public:
+    Calculator(int i) : id(i) {}
+    int getId() const { return id; }
+    int add(int x, int y) const { return x + y; }
+};
+
+struct Result {
+    double seconds;
+    std::uint64_t misses;
+    long long sum;
+};
+
+template <typename Body>
+Result measure(int repeats, Body body) {
+    BranchMissCounter counter;
+    body(); // warm up
+    long long sum = 0;
+    counter.start();
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < repeats; ++r) sum += body();
+    auto end = std::chrono::high_resolution_clock::now();
+    std::uint64_t misses = counter.stop();
+    return { std::chrono::duration<double>(end - start).count(), counter.available() ? misses : ~0ull, sum };
+}
+
+int main() {
+    const std::size_t N = 1'000'000;
+    const int repeats = 20;
+
+    Calculator calc1(101);
+    int offset = 3;
+    auto simpleLambda = [](int x) { return x + 1; };
+    auto captureLambda = [offset](int x) { return x * 3 + offset; };
+    auto boundFree = std::bind(freeFunction, std::placeholders::_1);
+    auto boundAddXY = std::bind(addXY, std::placeholders::_1, 5);
+    auto boundMethod = std::bind(&Calculator::add, &calc1, std::placeholders::_1, 10);
+
+    std::vector<std::function<int(int)>> funcs;
+    PolyCollection<int(int)> poly;
+    funcs.reserve(N);
+
+    std::mt19937 rng(10);
+    for (std::size_t i = 0; i < N; ++i) {
+        switch (rng() % 7) {
+        case 0: funcs.push_back(simpleLambda); poly.insert(simpleLambda); break;
+        case 1: funcs.push_back(captureLambda); poly.insert(captureLambda); break;
+        case 2: funcs.push_back(Multiply(3)); poly.insert(Multiply(3)); break;
+        case 3: funcs.push_back(&freeFunction); poly.insert(&freeFunction); break;
+        case 4: funcs.push_back(boundFree); poly.insert(boundFree); break;
+        case 5: funcs.push_back(boundAddXY); poly.insert(boundAddXY); break;
+        default: funcs.push_back(boundMethod); poly.insert(boundMethod); break;
+        }
+    }
+
+    std::cout << "=== " << N << " mixed callables, " << poly.segmentCount() << " concrete types ===\n";
+
+    // for_each with restitution: Multiply elements are seen as Multiply
+    long long factors = 0, others = 0;
+    poly.for_each<Multiply>([&](auto& f) {
+        if constexpr (std::is_same_v<std::decay_t<decltype(f)>, Multiply>) factors += f.factor;
+        else others += f(1);
+        });
+    std::cout << "for_each<Multiply>: sum of factors " << factors << ", other callables(1) summed " << others << "\n";
+
+    std::vector<int> out(N);
+    const int x = 10;
+    Result viaFunction = measure(repeats, [&] {
+        for (std::size_t i = 0; i < N; ++i) out[i] = funcs[i](x);
+        long long s = 0;
+        for (int v : out) s += v;
+        return s;
+        });
+    Result viaPoly = measure(repeats, [&] {
+        poly.invoke_all(out, x);
+        long long s = 0;
+        for (int v : out) s += v;
+        return s;
+        });
+
+    auto printRow = [&](const char* name, const Result& r) {
+        std::cout << std::left << std::setw(26) << name << std::right << std::fixed << std::setprecision(2)
+            << std::setw(8) << r.seconds / repeats / N * 1e9 << " ns/call";
+        if (r.misses != ~0ull) std::cout << std::setw(12) << double(r.misses) / repeats / N << " misses/call";
+        else std::cout << "      branch misses n/a";
+        std::cout << "\n";
+    };
+    printRow("vector<std::function>:", viaFunction);
+    printRow("PolyCollection:", viaPoly);
+    std::cout << "Speedup x" << viaFunction.seconds / viaPoly.seconds;
+    if (viaFunction.misses != ~0ull && viaPoly.misses)
+        std::cout << ", branch misses /" << double(viaFunction.misses) / viaPoly.misses;
+    std::cout << "\nSums " << (viaFunction.sum == viaPoly.sum ? "match" : "DIFFER") << " (order differs, the multiset of results does not)\n";
+
+    return 0;
+}
@@ -0,0 +1,180 @@
+// -----------------------------
+// Batched pipeline stages: one indirect call per batch, not per value
+// -----------------------------
+// Every stage is a std::function<void(span<const int>, span<int>)>. The
+// pipeline pushes the input through the stages in L1-sized chunks, so the
+// type-erased call is paid once per chunk and each stage's inner loop is a
+// plain loop the compiler can inline and vectorize.
+#include <iostream>
+#include <vector>
+#include <span>
+#include <functional>
+#include <concepts>
+#include <algorithm>
+#include <stdexcept>
+#include <chrono>
+
+using BatchStage = std::function<void(std::span<const int>, std::span<int>)>;
+
+// A callable with its own batch overload is used as is
+template <typename F>
+concept HasBatchCall = requires(F& f, std::span<const int> in, std::span<int> out) {
+    f(in, out);
+};
+
+// Any int(int) callable becomes a stage: the element loop is generated here,
+// where the callable's type is known, so the calls in it are direct
+template <typename F>
+BatchStage batched(F f)
+{
+    if constexpr (HasBatchCall<F>) {
+        return f;
+    }
+    else {
+        return [f = std::move(f)](std::span<const int> in, std::span<int> out) mutable {
+            for (std::size_t i = 0; i < in.size(); ++i) out[i] = f(in[i]);
+        };
+    }
+}
+
+class BatchPipeline
+{
+public:
+    explicit BatchPipeline(std::size_t chunkSize = 2048) : chunk(chunkSize), bufA(chunkSize), bufB(chunkSize)
+    {
+        if (chunkSize == 0) throw std::invalid_argument("BatchPipeline: chunk size must be positive");
+    }
+
+    template <typename F>
+    void addStage(F f) { stages.push_back(batched(std::move(f))); }
+
+    // out[i] = stageN(... stage1(in[i])), state advancing in input order
+    void run(std::span<const int> in, std::span<int> out)
+    {
+        if (out.size() < in.size()) throw std::invalid_argument("BatchPipeline::run: output too small");
+        if (stages.empty()) {
+            std::copy(in.begin(), in.end(), out.begin());
+            return;
+        }
+        for (std::size_t pos = 0; pos < in.size(); pos += chunk) {
+            std::size_t n = std::min(chunk, in.size() - pos);
+            std::span<const int> src = in.subspan(pos, n);
+            for (std::size_t s = 0; s < stages.size(); ++s) {
+                bool last = s + 1 == stages.size();
+                std::span<int> dst = last ? out.subspan(pos, n) : std::span<int>(s % 2 ? bufB : bufA).first(n);
+                stages[s](src, dst);
+                src = dst;
+            }
+        }
+    }
+
+private:
+    std::size_t chunk;
+    std::vector<int> bufA, bufB; // ping-pong between stages, small enough to stay in L1
+    std::vector<BatchStage> stages;
+};
+
+// -----------------------------
+// Stages from 10_stdFunction_1 (without printing)
+// -----------------------------
+int freeFunction(int x) { return x * 2; }
+int addXY(int x, int y) { return x + y; }
+
+struct Multiply
+{
+    int factor;
+    Multiply(int f) : factor(f) {}
+
+    int operator()(int x) const { return x * factor; }
+
+    void operator()(std::span<const int> in, std::span<int> out) const
+    {
+        for (std::size_t i = 0; i < in.size(); ++i) out[i] = in[i] * factor;
+    }
+};
+
+class Calculator
+{
+private:
+    int id;
+public:
+    Calculator(int i) : id(i) {}
+    int getId() const { return id; }
+    int add(int x, int y) const { return x + y; }
+};
+
+// statefulLambda: call k adds capturedValue + k. Its batch form computes the
+// whole batch from the state at entry, then advances the state once.
+struct StatefulAdd
+{
+    int capturedValue;
+
+    int operator()(int x)
+    {
+        capturedValue += 1;
+        return x + capturedValue;
+    }
+
+    void operator()(std::span<const int> in, std::span<int> out)
+    {
+        const int base = capturedValue + 1;
+        for (std::size_t i = 0; i < in.size(); ++i) out[i] = in[i] + base + static_cast<int>(i);
+        capturedValue += static_cast<int>(in.size());
+    }
+};
+
+int main()
+{
+    const std::size_t N = 4'000'000;
+    const int repeats = 5;
+    std::vector<int> input(N), outElement(N), outBatch(N);
+    for (std::size_t i = 0; i < N; ++i) input[i] = static_cast<int>(i % 1000);
+
+    Calculator calc1(101);
+    int capturedValue = 5;
+
+    // Per-element: every value goes through every std::function<int(int)>
+    std::vector<std::function<int(int)>> funcs;
+    funcs.push_back([](int x) { return x + 1; });
+    funcs.push_back([capturedValue](int x) mutable { capturedValue += 1; return x + capturedValue; });
+    funcs.push_back(Multiply(3));
+    funcs.push_back(&freeFunction);
+    funcs.push_back(std::bind(addXY, std::placeholders::_1, 5));
+    funcs.push_back(std::bind(&Calculator::add, &calc1, std::placeholders::_1, 10));
+
+    // Batched: the same stages
+    BatchPipeline pipeline;
+    pipeline.addStage([](int x) { return x + 1; });
+    pipeline.addStage(StatefulAdd{ capturedValue });
+    pipeline.addStage(Multiply(3));
+    pipeline.addStage(&freeFunction);
+    pipeline.addStage(std::bind(addXY, std::placeholders::_1, 5));
+    pipeline.addStage(std::bind(&Calculator::add, &calc1, std::placeholders::_1, 10));
+
+    std::cout << "=== " << funcs.size() << " stages, " << N << " values x " << repeats << " runs ===\n";
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < repeats; ++r) {
+        for (std::size_t i = 0; i < N; ++i) {
+            int v = input[i];
+            for (auto& f : funcs) v = f(v);
+            outElement[i] = v;
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double tElement = std::chrono::duration<double>(end - start).count();
+
+    start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < repeats; ++r) pipeline.run(input, outBatch);
+    end = std::chrono::high_resolution_clock::now();
+    double tBatch = std::chrono::duration<double>(end - start).count();
+
+    double values = double(N) * repeats;
+    std::cout << "Per-element std::function<int(int)>:  " << tElement << " s (" << values / tElement / 1e6 << " M values/s)\n";
+    std::cout << "Batched span stages:                  " << tBatch << " s (" << values / tBatch / 1e6 << " M values/s)\n";
+    std::cout << "Speedup x" << tElement / tBatch << "\n";
+    std::cout << "Outputs (including the stateful stage) " << (outElement == outBatch ? "match" : "DIFFER") << "\n";
+    std::cout << "First results: " << outBatch[0] << ", " << outBatch[1] << ", " << outBatch[2] << "\n";
+
+    return 0;
+}
@@ -0,0 +1,392 @@
+// -----------------------------
+// Work-stealing executor for the event queue of 11_stdFunction_2
+// -----------------------------
+// - each worker owns a Chase-Lev deque: it pushes and pops at the bottom
+//   (LIFO, cache-warm), other workers steal from the top (FIFO, oldest and
+//   usually largest tasks)
+// - a task submitted from inside a task goes to the current worker's deque;
+//   submissions from outside go through a small shared injection queue
+// - idle workers steal from random victims, then sleep
+// - wait_idle() returns once every submitted task, including tasks those
+//   tasks scheduled, has finished
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <string>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
+#include <chrono>
+
+// -----------------------------
+// Chase-Lev deque
+// -----------------------------
+// "Correct and Efficient Work-Stealing for Weak Memory Models", Le et al. 2013.
+// Stores pointers; the owner thread calls push/pop, any thread calls steal.
+template <typename T>
+class ChaseLevDeque {
+public:
+    explicit ChaseLevDeque(std::int64_t capacity = 256) : array(new Array(capacity)) {
+        retired.emplace_back(array.load(std::memory_order_relaxed));
+    }
+
+    ChaseLevDeque(const ChaseLevDeque&) = delete;
+    ChaseLevDeque& operator=(const ChaseLevDeque&) = delete;
+
+    void push(T* item) {
+        std::int64_t b = bottom.load(std::memory_order_relaxed);
+        std::int64_t t = top.load(std::memory_order_acquire);
+        Array* a = array.load(std::memory_order_relaxed);
+        if (b - t > a->capacity - 1) a = grow(a, t, b);
+        a->put(b, item);
+        bottom.store(b + 1, std::memory_order_release); // publishes the item to thieves
+    }
+
+    T* pop() {
+        std::int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        Array* a = array.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst); // against a concurrent steal of the last item
+        std::int64_t t = top.load(std::memory_order_relaxed);
+
+        if (t > b) { // empty
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        T* item = a->get(b);
+        if (t == b) { // last item: race the thieves for it
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) item = nullptr;
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    T* steal() {
+        std::int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b) return nullptr;
+
+        Array* a = array.load(std::memory_order_acquire);
+        T* item = a->get(t);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) return nullptr;
+        return item;
+    }
+
+    bool empty() const {
+        return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Array {
+        std::int64_t capacity;
+        std::int64_t mask;
+        std::unique_ptr<std::atomic<T*>[]> slots;
+
+        explicit Array(std::int64_t c) : capacity(c), mask(c - 1), slots(new std::atomic<T*>[c]) {}
+
+        T* get(std::int64_t i) const { return slots[i & mask].load(std::memory_order_relaxed); }
+        void put(std::int64_t i, T* v) { slots[i & mask].store(v, std::memory_order_relaxed); }
+    };
+
+    // Old arrays stay alive until the deque dies: a thief may still read one
+    Array* grow(Array* old, std::int64_t t, std::int64_t b) {
+        auto bigger = std::make_unique<Array>(old->capacity * 2);
+        for (std::int64_t i = t; i < b; ++i) bigger->put(i, old->get(i));
+        Array* a = bigger.get();
+        retired.push_back(std::move(bigger));
+        array.store(a, std::memory_order_release);
+        return a;
+    }
+
+    alignas(64) std::atomic<std::int64_t> top{ 0 };
+    alignas(64) std::atomic<std::int64_t> bottom{ 0 };
+    std::atomic<Array*> array;
+    std::vector<std::unique_ptr<Array>> retired; // owner thread only
+};
+
+// -----------------------------
+// Thread pool
+// -----------------------------
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit WorkStealingPool(unsigned threads = std::thread::hardware_concurrency()) {
+        if (threads == 0) threads = 1;
+        for (unsigned i = 0; i < threads; ++i) workers.push_back(std::make_unique<Worker>());
+        for (unsigned i = 0; i < threads; ++i) workers[i]->thread = std::thread([this, i] { run(i); });
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        sleepCv.notify_all();
+        for (auto& w : workers) w->thread.join();
+
+        // Tasks never run (the pool was destroyed while busy) are freed here
+        for (auto& w : workers) while (Task* t = w->tasks.pop()) delete t;
+        for (Task* t : injected) delete t;
+    }
+
+    void submit(Task task) {
+        pending.fetch_add(1, std::memory_order_relaxed);
+        Task* t = new Task(std::move(task));
+        if (current.pool == this) {
+            workers[current.index]->tasks.push(t); // nested: stays on this worker
+        }
+        else {
+            std::lock_guard<std::mutex> lock(injectMutex);
+            injected.push_back(t);
+        }
+        wakeOne();
+    }
+
+    // Quiescence: returns when no task is queued or running. Rethrows the
+    // first exception a task threw since the last call.
+    void wait_idle() {
+        std::unique_lock<std::mutex> lock(idleMutex);
+        idleCv.wait(lock, [this] { return pending.load(std::memory_order_acquire) == 0; });
+        if (firstError) std::rethrow_exception(std::exchange(firstError, nullptr));
+    }
+
+    unsigned size() const { return static_cast<unsigned>(workers.size()); }
+
+    std::uint64_t steals() const {
+        std::uint64_t s = 0;
+        for (auto& w : workers) s += w->steals.load(std::memory_order_relaxed);
+        return s;
+    }
+
+private:
+    struct Worker {
+        ChaseLevDeque<Task> tasks;
+        std::thread thread;
+        std::atomic<std::uint64_t> steals{ 0 };
+    };
+
+    struct Current {
+        WorkStealingPool* pool = nullptr;
+        unsigned index = 0;
+    };
+    static thread_local Current current;
+
+    Task* findTask(unsigned self, std::uint32_t& rng) {
+        if (Task* t = workers[self]->tasks.pop()) return t;
+        {
+            std::lock_guard<std::mutex> lock(injectMutex);
+            if (!injected.empty()) {
+                Task* t = injected.front();
+                injected.pop_front();
+                return t;
+            }
+        }
+        // Random victims: no fixed order, so thieves do not all pile onto worker 0
+        const unsigned n = size();
+        for (unsigned attempt = 0; attempt < 2 * n; ++attempt) {
+            rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; // xorshift32
+            unsigned victim = rng % n;
+            if (victim == self) continue;
+            if (Task* t = workers[victim]->tasks.steal()) {
+                workers[self]->steals.fetch_add(1, std::memory_order_relaxed);
+                return t;
+            }
+        }
+        return nullptr;
+    }
+
+    void run(unsigned self) {
+        current = { this, self };
+        std::uint32_t rng = 2463534242u + self * 7919u;
+        for (;;) {
+            std::uint64_t seen = signal.load(std::memory_order_seq_cst);
+            Task* t = findTask(self, rng);
+            if (t) {
+                execute(t);
+                continue;
+            }
+            // Nothing found: sleep until something is submitted after `seen`
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            if (stopping) return;
+            sleepers.fetch_add(1, std::memory_order_seq_cst);
+            sleepCv.wait(lock, [&] { return stopping || signal.load(std::memory_order_seq_cst) != seen; });
+            sleepers.fetch_sub(1, std::memory_order_relaxed);
+            if (stopping) return;
+        }
+    }
+
+    void execute(Task* t) {
+        try {
+            (*t)();
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(idleMutex);
+            if (!firstError) firstError = std::current_exception();
+        }
+        delete t;
+        if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(idleMutex); // pairs with the predicate check in wait_idle
+            idleCv.notify_all();
+        }
+    }
+
+    void wakeOne() {
+        signal.fetch_add(1, std::memory_order_seq_cst);
+        if (sleepers.load(std::memory_order_seq_cst) > 0) {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            sleepCv.notify_one();
+        }
+    }
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    std::mutex injectMutex;
+    std::deque<Task*> injected;
+
+    std::atomic<std::int64_t> pending{ 0 };
+    std::mutex idleMutex;
+    std::condition_variable idleCv;
+    std::exception_ptr firstError;
+
+    std::atomic<std::uint64_t> signal{ 0 };
+    std::atomic<int> sleepers{ 0 };
+    std::mutex sleepMutex;
+    std::condition_variable sleepCv;
+    bool stopping = false;
+};
+
+thread_local WorkStealingPool::Current WorkStealingPool::current;
+
+// -----------------------------
+// Fine-grained task tree
+// -----------------------------
+// Each task does a little arithmetic and spawns two children until depth 0:
+// 2^(depth+1) - 1 tasks, most of them a few hundred nanoseconds long.
+std::uint64_t leafWork(std::uint64_t seed) {
+    for (int i = 0; i < 200; ++i) seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    return seed >> 60;
+}
+
+void spawnTree(WorkStealingPool& pool, int depth, std::uint64_t seed, std::atomic<std::uint64_t>& sum) {
+    sum.fetch_add(leafWork(seed), std::memory_order_relaxed);
+    if (depth == 0) return;
+    pool.submit([&pool, depth, seed, &sum] { spawnTree(pool, depth - 1, seed * 2, sum); });
+    pool.submit([&pool, depth, seed, &sum] { spawnTree(pool, depth - 1, seed * 2 + 1, sum); });
+}
+
+// -----------------------------
+// The callables of 11_stdFunction_2
+// -----------------------------
+struct Logger {
+    std::string prefix;
+    Logger(const std::string& p) : prefix(p) {}
+    void operator()(const std::string& message) const {
+        std::cout << prefix << message << "\n";
+    }
+};
+
+class Worker {
+private:
+    int id;
+public:
+    Worker(int i) : id(i) {}
+
+    void processTask(int value) const {
+        std::cout << "[Worker " << id << "] Processing value: " << value
+            << ", squared = " << value * value << "\n";
+    }
+};
+
+void printSum(int x, int y) {
+    std::cout << "[Free function] Sum = " << x + y << "\n";
+}
+
+std::uint64_t sequentialTree(int depth, std::uint64_t seed) {
+    std::uint64_t s = leafWork(seed);
+    if (depth == 0) return s;
+    return s + sequentialTree(depth - 1, seed * 2) + sequentialTree(depth - 1, seed * 2 + 1);
+}
+
+int main() {
+    std::cout << "=== Event loop of 11_stdFunction_2 on the pool ===\n";
+    {
+        WorkStealingPool pool(4);
+        std::mutex printMutex;
+        // The tasks print with plain std::cout, as in 11: one at a time keeps lines whole
+        auto submitPrinting = [&](auto task) {
+            pool.submit([&printMutex, task = std::move(task)]() mutable {
+                std::lock_guard<std::mutex> lock(printMutex);
+                task();
+                });
+        };
+        int counter = 0;
+
+        submitPrinting([&]() {
+            std::cout << "[Lambda] scheduling a new task dynamically\n";
+            submitPrinting([]() { std::cout << "[Dynamically added lambda] Hello from dynamically scheduled task!\n"; });
+            });
+        Logger logger("Logger: ");
+        submitPrinting(std::bind(logger, "Initial log event"));
+        submitPrinting(std::bind(printSum, 3, 4));
+        Worker w1(1);
+        Worker w2(2);
+        submitPrinting(std::bind(&Worker::processTask, &w1, 5));
+        submitPrinting(std::bind(&Worker::processTask, &w2, 8));
+        submitPrinting([&counter]() {
+            counter += 10; // under printMutex, like every task here
+            std::cout << "[Lambda reference] counter = " << counter << "\n";
+            });
+        pool.wait_idle();
+        std::cout << "Final counter value = " << counter << " (order varies between runs)\n";
+
+        pool.submit([] { throw std::runtime_error("task failed"); });
+        try {
+            pool.wait_idle();
+        }
+        catch (const std::exception& e) {
+            std::cout << "wait_idle rethrew: " << e.what() << "\n";
+        }
+    }
+
+    // -----------------------------
+    // Scaling
+    // -----------------------------
+    const int depth = 18;
+    const std::uint64_t tasks = (1ull << (depth + 1)) - 1;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::uint64_t expected = sequentialTree(depth, 1);
+    auto end = std::chrono::high_resolution_clock::now();
+    double tSeq = std::chrono::duration<double>(end - start).count();
+
+    std::cout << "\n=== " << tasks << " fine-grained tasks (" << std::thread::hardware_concurrency() << " hardware threads) ===\n";
+    std::cout << "sequential recursion:   " << tSeq * 1e3 << " ms\n";
+
+    unsigned maxThreads = std::max(4u, std::thread::hardware_concurrency());
+    bool allCorrect = true;
+    for (unsigned n = 1; n <= maxThreads; n *= 2) {
+        WorkStealingPool pool(n);
+        std::atomic<std::uint64_t> sum{ 0 };
+        start = std::chrono::high_resolution_clock::now();
+        pool.submit([&] { spawnTree(pool, depth, 1, sum); });
+        pool.wait_idle();
+        end = std::chrono::high_resolution_clock::now();
+        double t = std::chrono::duration<double>(end - start).count();
+        allCorrect = allCorrect && sum.load() == expected;
+        std::cout << n << " worker(s):            " << t * 1e3 << " ms, " << tasks / t / 1e6 << " M tasks/s, "
+            << pool.steals() << " steals\n";
+    }
+    std::cout << "Results " << (allCorrect ? "match" : "DIFFER") << "\n";
+
+    return allCorrect ? 0 : 1;
+}
@@ -0,0 +1,331 @@
+// -----------------------------
+// Double-buffered event queue with arena-allocated tasks
+// -----------------------------
+// The queue of 11_stdFunction_2 appends to the vector it is draining, and
+// every std::function whose closure is larger than its small buffer goes to
+// the heap. Here:
+// - tasks posted while tick N runs are collected for tick N + 1, so the list
+//   being iterated is never modified (no reallocation under the loop)
+// - each closure is placement-constructed into the tick's bump arena; it is
+//   destroyed right after it runs, so the arena is reset in O(1) afterwards
+// - arenas and task lists keep their memory: after warm-up, ticks allocate
+//   nothing at all
+#include <iostream>
+#include <vector>
+#include <functional>
+#include <memory>
+#include <new>
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <stdexcept>
+#include <chrono>
+
+// -----------------------------
+// Global new/delete overrides: count instead of printing
+// -----------------------------
+static std::size_t g_allocations = 0;
+
+void* operator new(std::size_t n) noexcept(false) {
+    if (n == 0) n = 1;
+    void* p = std::malloc(n);
+    if (!p) throw std::bad_alloc();
+    ++g_allocations;
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+// -----------------------------
+// Bump arena
+// -----------------------------
+class BumpArena {
+public:
+    explicit BumpArena(std::size_t chunkSize = 64 * 1024) : chunkSize(chunkSize) {}
+
+    BumpArena(const BumpArena&) = delete;
+    BumpArena& operator=(const BumpArena&) = delete;
+
+    void* allocate(std::size_t size, std::size_t align) {
+        for (;;) {
+            if (current < chunks.size()) {
+                // align the address, not the offset: the chunk itself is only new-aligned
+                std::uintptr_t address = reinterpret_cast<std::uintptr_t>(chunks[current].data.get() + offset);
+                std::size_t aligned = offset + ((align - (address & (align - 1))) & (align - 1));
+                if (aligned + size <= chunks[current].size) {
+                    offset = aligned + size;
+                    return chunks[current].data.get() + aligned;
+                }
+                ++current; // this chunk is full: move on to the next one
+                offset = 0;
+                continue;
+            }
+            std::size_t size0 = size + align > chunkSize ? size + align : chunkSize; // oversized requests get their own chunk
+            chunks.push_back({ std::unique_ptr<std::byte[]>(new std::byte[size0]), size0 });
+        }
+    }
+
+    // O(1): chunks are kept for the next tick
+    void reset() {
+        current = 0;
+        offset = 0;
+    }
+
+    std::size_t reservedBytes() const {
+        std::size_t total = 0;
+        for (auto& c : chunks) total += c.size;
+        return total;
+    }
+
+private:
+    struct Chunk {
+        std::unique_ptr<std::byte[]> data;
+        std::size_t size;
+    };
+
+    std::size_t chunkSize;
+    std::vector<Chunk> chunks;
+    std::size_t current = 0;
+    std::size_t offset = 0;
+};
+
+// -----------------------------
+// Event queue
+// -----------------------------
+class EventQueue {
+public:
+    EventQueue() = default;
+    EventQueue(const EventQueue&) = delete;
+    EventQueue& operator=(const EventQueue&) = delete;
+
+    // Tasks that never ran are destroyed without running
+    ~EventQueue() {
+        for (Task& task : ticks[next].tasks) task.destroy(task.object);
+    }
+
+    // The task runs on the next tick. Any callable; it lives in the arena.
+    template <typename F>
+    void post(F&& f) {
+        using T = std::decay_t<F>;
+        Tick& t = ticks[next];
+        void* mem = t.arena.allocate(sizeof(T), alignof(T));
+        ::new (mem) T(std::forward<F>(f));
+        t.tasks.push_back({ &runAndDestroy<T>, &destroy<T>, mem });
+    }
+
+    // Runs every task posted before this call; returns how many ran. If a
+    // task throws, the rest of this tick is destroyed without running and
+    // the exception propagates; tasks already posted for the next tick stay.
+    std::size_t runTick() {
+        std::swap(current, next);
+        Tick& t = ticks[current];
+        std::size_t n = t.tasks.size();
+        std::size_t i = 0;
+        struct Finish {
+            Tick& t;
+            std::size_t& i;
+            ~Finish() {
+                for (; i < t.tasks.size(); ++i) t.tasks[i].destroy(t.tasks[i].object); // only after a throw
+                t.tasks.clear();   // keeps capacity
+                t.arena.reset();   // every closure has been destroyed
+            }
+        } finish{ t, i };
+        while (i < n) {
+            Task& task = t.tasks[i++]; // counted as done before it runs: runAndDestroy destroys it even if it throws
+            task.run(task.object);     // posts go to the other tick
+        }
+        return n;
+    }
+
+    // Runs ticks until no task is left
+    std::size_t runUntilEmpty() {
+        std::size_t total = 0;
+        while (!ticks[next].tasks.empty()) total += runTick();
+        return total;
+    }
+
+    std::size_t pending() const { return ticks[next].tasks.size(); }
+
+    std::size_t reservedBytes() const { return ticks[0].arena.reservedBytes() + ticks[1].arena.reservedBytes(); }
+
+private:
+    struct Task {
+        void (*run)(void* object);     // runs, then destroys
+        void (*destroy)(void* object); // destroys without running
+        void* object;
+    };
+
+    struct Tick {
+        BumpArena arena;
+        std::vector<Task> tasks;
+    };
+
+    template <typename T>
+    static void runAndDestroy(void* object) {
+        T* task = static_cast<T*>(object);
+        struct Destroy { T* t; ~Destroy() { t->~T(); } } guard{ task }; // destroyed even if it throws
+        (*task)();
+    }
+
+    template <typename T>
+    static void destroy(void* object) { static_cast<T*>(object)->~T(); }
+
+    Tick ticks[2];
+    int current = 0;
+    int next = 1;
+};
+
+// -----------------------------
+// The tasks of 11_stdFunction_2
+// -----------------------------
+struct Logger {
+    const char* prefix;
+    void operator()(const char* message) const { std::cout << prefix << message << "\n"; }
+};
+
+class Worker {
+private:
+    int id;
+public:
+    Worker(int i) : id(i) {}
+    void processTask(int value) const {
+        std::cout << "[Worker " << id << "] Processing value: " << value << ", squared = " << value * value << "\n";
+    }
+};
+
+void printSum(int x, int y) { std::cout << "[Free function] Sum = " << x + y << "\n"; }
+
+// Benchmark task: some captured state, larger than std::function's small buffer
+struct Payload {
+    long long a, b, c;
+};
+
+int main() {
+    std::cout << "=== Event loop of 11_stdFunction_2, one tick at a time ===\n";
+    EventQueue queue;
+    int counter = 0;
+
+    queue.post([&queue]() {
+        std::cout << "[Lambda] scheduling a new task for the next tick\n";
+        queue.post([]() { std::cout << "[Dynamically added lambda] Hello from dynamically scheduled task!\n"; });
+        });
+    queue.post(std::bind(Logger{ "Logger: " }, "Initial log event"));
+    queue.post(std::bind(printSum, 3, 4));
+    Worker w1(1);
+    Worker w2(2);
+    queue.post(std::bind(&Worker::processTask, &w1, 5));
+    queue.post(std::bind(&Worker::processTask, &w2, 8));
+    queue.post([&counter]() {
+        counter += 10;
+        std::cout << "[Lambda reference] counter = " << counter << "\n";
+        });
+
+    int tick = 0;
+    while (queue.pending()) {
+        std::cout << "-- tick " << tick++ << "\n";
+        queue.runTick();
+    }
+    std::cout << "Final counter value = " << counter << "\n";
+
+    // A throwing task ends its tick; the tasks after it are dropped, not run twice
+    std::cout << "\n=== A task that throws ===\n";
+    struct alignas(64) Aligned {
+        int value;
+        void operator()() const {
+            bool ok = reinterpret_cast<std::uintptr_t>(this) % 64 == 0;
+            std::cout << "[Aligned task] " << value << (ok ? " (64-byte aligned)" : " (MISALIGNED)") << "\n";
+        }
+    };
+    queue.post([]() { std::cout << "[Before] runs once\n"; });
+    queue.post(Aligned{ 1 });
+    queue.post([]() { throw std::runtime_error("task failed"); });
+    queue.post([]() { std::cout << "[After] not reached\n"; });
+    try {
+        queue.runTick();
+    }
+    catch (const std::exception& e) {
+        std::cout << "runTick threw: " << e.what() << ", pending afterwards: " << queue.pending() << "\n";
+    }
+    queue.post(Aligned{ 2 });
+    queue.runUntilEmpty();
+
+    // -----------------------------
+    // Benchmark: chains of tasks that re-post themselves
+    // -----------------------------
+    const int chains = 10'000;
+    const int ticks = 200;
+    long long sum = 0;
+
+    // Arena queue: every task posts its successor for the next tick
+    struct ArenaChain {
+        EventQueue* q;
+        long long* sum;
+        int remaining;
+        Payload p;
+        void operator()() const {
+            *sum += p.a + p.b + p.c + remaining;
+            if (remaining > 0) q->post(ArenaChain{ q, sum, remaining - 1, { p.b, p.c, p.a + 1 } });
+        }
+    };
+
+    EventQueue arenaQueue;
+    for (int i = 0; i < chains; ++i) arenaQueue.post(ArenaChain{ &arenaQueue, &sum, ticks - 1, { i, 1, 2 } });
+    arenaQueue.runTick(); // warm-up tick: arenas and task lists reach their working size
+    arenaQueue.runTick();
+
+    std::size_t before = g_allocations;
+    auto start = std::chrono::high_resolution_clock::now();
+    std::size_t arenaTasks = arenaQueue.runUntilEmpty();
+    auto end = std::chrono::high_resolution_clock::now();
+    std::size_t arenaAllocs = g_allocations - before;
+    double tArena = std::chrono::duration<double>(end - start).count();
+    long long arenaSum = sum;
+
+    // The 11_stdFunction_2 way: one vector<std::function>, appended while draining
+    struct VectorChain {
+        std::vector<std::function<void()>>* q;
+        long long* sum;
+        int remaining;
+        Payload p;
+        void operator()() const {
+            *sum += p.a + p.b + p.c + remaining;
+            if (remaining > 0) q->push_back(VectorChain{ q, sum, remaining - 1, { p.b, p.c, p.a + 1 } });
+        }
+    };
+
+    sum = 0;
+    std::vector<std::function<void()>> eventQueue;
+    for (int i = 0; i < chains; ++i) eventQueue.push_back(VectorChain{ &eventQueue, &sum, ticks - 1, { i, 1, 2 } });
+    std::size_t i = 0;
+    for (; i < 2 * static_cast<std::size_t>(chains); ++i) eventQueue[i](); // same warm-up
+
+    before = g_allocations;
+    start = std::chrono::high_resolution_clock::now();
+    std::size_t vectorTasks = 0;
+    while (i < eventQueue.size()) {
+        std::function<void()> task = std::move(eventQueue[i]); // push_back inside may reallocate the vector
+        task();
+        ++i;
+        ++vectorTasks;
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::size_t vectorAllocs = g_allocations - before;
+    double tVector = std::chrono::duration<double>(end - start).count();
+
+    std::cout << "\n=== " << chains << " task chains x " << ticks << " ticks ===\n";
+    std::cout << "vector<std::function>: " << vectorTasks / tVector / 1e6 << " M tasks/s, "
+        << vectorAllocs << " allocations\n";
+    std::cout << "Arena event queue:     " << arenaTasks / tArena / 1e6 << " M tasks/s, "
+        << arenaAllocs << " allocations" << (arenaAllocs == 0 ? " (steady state: none)" : "") << "\n";
+    std::cout << "Arena memory kept:     " << queue.reservedBytes() + arenaQueue.reservedBytes() << " bytes\n";
+    std::cout << "Results " << (arenaSum == sum && arenaTasks == vectorTasks ? "match" : "DIFFER") << "\n";
+
+    return 0;
+}
@@ -0,0 +1,348 @@
+// -----------------------------
+// Hierarchical timer wheel for the event loop of 11_stdFunction_2
+// -----------------------------
+// Time advances in ticks (e.g. 1 ms). Four wheels of 256 slots cover 2^32
+// ticks: a timer goes into the coarsest wheel that still separates it from
+// now, and moves down one wheel whenever the finer wheel wraps around.
+// - schedule: O(1), append to a slot list
+// - cancel:   O(1), unlink from a doubly-linked slot list through the handle
+// - expiry:   all timers of a slot are detached at once and run as a batch
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <queue>
+#include <functional>
+#include <random>
+#include <chrono>
+#include <cstdint>
+
+// -----------------------------
+// Timer wheel
+// -----------------------------
+struct TimerHandle {
+    std::uint32_t index = 0;
+    std::uint32_t generation = 0; // 0 is never issued
+};
+
+class TimerWheel {
+public:
+    using Callback = std::function<void()>;
+
+    static constexpr int Levels = 4;
+    static constexpr int SlotBits = 8;
+    static constexpr int Slots = 1 << SlotBits;
+
+    TimerWheel() {
+        for (auto& h : heads) h = None;
+    }
+
+    std::uint64_t now() const { return currentTick; }
+    std::size_t size() const { return live; }
+
+    // Fires `delay` ticks from now (at least 1); again every `period` ticks if period > 0
+    TimerHandle schedule(std::uint64_t delay, Callback cb, std::uint32_t period = 0) {
+        std::uint32_t i = allocate();
+        Node& n = nodes[i];
+        n.expiry = currentTick + (delay ? delay : 1);
+        n.period = period;
+        n.callback = std::move(cb);
+        link(i);
+        ++live;
+        return { i, n.generation };
+    }
+
+    bool cancel(TimerHandle h) {
+        if (h.index >= nodes.size() || nodes[h.index].generation != h.generation) return false;
+        Node& n = nodes[h.index];
+        if (n.slot != Expiring) unlink(h.index);
+        release(h.index); // an expiring timer is skipped by the batch: its generation changed
+        return true;
+    }
+
+    // Advances to `tick`, running every timer that expires on the way
+    std::size_t advanceTo(std::uint64_t tick) {
+        std::size_t fired = 0;
+        while (currentTick < tick) {
+            if (live == 0) { // nothing can fire: jump (the wheels are all empty)
+                currentTick = tick;
+                break;
+            }
+            ++currentTick;
+            cascade();
+            fired += expireSlot(static_cast<std::uint32_t>(currentTick & (Slots - 1)));
+        }
+        return fired;
+    }
+
+private:
+    static constexpr std::uint32_t None = 0xffffffffu;
+    static constexpr std::uint32_t Expiring = 0xfffffffeu;
+
+    struct Node {
+        std::uint64_t expiry = 0;
+        std::uint32_t period = 0;
+        std::uint32_t generation = 1;
+        std::uint32_t prev = None;
+        std::uint32_t next = None;    // also links the free list
+        std::uint32_t slot = None;    // level * Slots + slot, Expiring, or None when free
+        Callback callback;
+    };
+
+    std::uint32_t slotFor(std::uint64_t expiry) const {
+        std::uint64_t delta = expiry - currentTick;
+        for (int level = 0; level < Levels - 1; ++level) {
+            if (delta < (std::uint64_t(1) << (SlotBits * (level + 1))))
+                return level * Slots + ((expiry >> (SlotBits * level)) & (Slots - 1));
+        }
+        // Last wheel: anything beyond its range waits in its farthest slot and is re-placed on cascade
+        const std::uint64_t maxDelta = (std::uint64_t(1) << (SlotBits * Levels)) - 1;
+        std::uint64_t e = delta > maxDelta ? currentTick + maxDelta : expiry;
+        return (Levels - 1) * Slots + ((e >> (SlotBits * (Levels - 1))) & (Slots - 1));
+    }
+
+    void link(std::uint32_t i) {
+        Node& n = nodes[i];
+        n.slot = slotFor(n.expiry);
+        n.prev = None;
+        n.next = heads[n.slot];
+        if (n.next != None) nodes[n.next].prev = i;
+        heads[n.slot] = i;
+    }
+
+    void unlink(std::uint32_t i) {
+        Node& n = nodes[i];
+        if (n.prev != None) nodes[n.prev].next = n.next;
+        else heads[n.slot] = n.next;
+        if (n.next != None) nodes[n.next].prev = n.prev;
+        n.slot = None;
+    }
+
+    std::uint32_t allocate() {
+        if (freeHead != None) {
+            std::uint32_t i = freeHead;
+            freeHead = nodes[i].next;
+            return i;
+        }
+        nodes.emplace_back(); // deque: running callbacks are never moved by this
+        return static_cast<std::uint32_t>(nodes.size() - 1);
+    }
+
+    void release(std::uint32_t i) {
+        Node& n = nodes[i];
+        n.callback = nullptr;
+        n.slot = None;
+        if (++n.generation == 0) n.generation = 1;
+        n.next = freeHead;
+        freeHead = i;
+        --live;
+    }
+
+    // When a wheel wraps, the matching slot of the next wheel is spread over the finer ones
+    void cascade() {
+        for (int level = 1; level < Levels; ++level) {
+            if ((currentTick & ((std::uint64_t(1) << (SlotBits * level)) - 1)) != 0) break;
+            std::uint32_t slot = level * Slots + ((currentTick >> (SlotBits * level)) & (Slots - 1));
+            std::uint32_t i = heads[slot];
+            heads[slot] = None;
+            while (i != None) {
+                std::uint32_t next = nodes[i].next;
+                link(i);
+                i = next;
+            }
+        }
+    }
+
+    std::size_t expireSlot(std::uint32_t slot) {
+        // Detach the whole list first: callbacks may schedule or cancel freely
+        batch.clear();
+        for (std::uint32_t i = heads[slot]; i != None; i = nodes[i].next) {
+            nodes[i].slot = Expiring;
+            batch.push_back({ i, nodes[i].generation });
+        }
+        heads[slot] = None;
+
+        std::size_t fired = 0;
+        for (std::size_t k = 0; k < batch.size(); ++k) {
+            TimerHandle h = batch[k];
+            if (nodes[h.index].generation != h.generation) continue; // cancelled by an earlier callback
+            Callback cb = std::move(nodes[h.index].callback); // survives the timer cancelling itself
+            cb();
+            ++fired;
+            Node& n = nodes[h.index];
+            if (n.generation != h.generation) continue; // cancelled itself
+            if (n.period) {
+                n.expiry += n.period;
+                n.callback = std::move(cb);
+                link(h.index);
+            }
+            else {
+                release(h.index);
+            }
+        }
+        return fired;
+    }
+
+    std::deque<Node> nodes;
+    std::uint32_t heads[Levels * Slots];
+    std::uint32_t freeHead = None;
+    std::uint64_t currentTick = 0;
+    std::size_t live = 0;
+    std::vector<TimerHandle> batch;
+};
+
+// -----------------------------
+// Event loop: immediate tasks plus timers
+// -----------------------------
+class EventLoop {
+public:
+    using Task = std::function<void()>;
+
+    explicit EventLoop(std::chrono::milliseconds tick = std::chrono::milliseconds(1))
+        : tickLength(tick), start(std::chrono::steady_clock::now()) {}
+
+    void post(Task t) { ready.push_back(std::move(t)); }
+
+    TimerHandle after(std::uint64_t ticks, Task t) { return wheel.schedule(ticks, std::move(t)); }
+    TimerHandle every(std::uint32_t ticks, Task t) { return wheel.schedule(ticks, std::move(t), ticks); }
+    bool cancel(TimerHandle h) { return wheel.cancel(h); }
+
+    std::uint64_t now() const { return wheel.now(); }
+
+    // Virtual time: advance n ticks, running what becomes due
+    void runTicks(std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) {
+            wheel.advanceTo(wheel.now() + 1);
+            drain();
+        }
+    }
+
+    // Real time: catch the wheel up with the steady clock
+    void poll() {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        wheel.advanceTo(static_cast<std::uint64_t>(elapsed / tickLength));
+        drain();
+    }
+
+private:
+    // Tasks posted while draining run in the same drain, after the current batch
+    void drain() {
+        while (!ready.empty()) {
+            running.swap(ready);
+            for (auto& t : running) t();
+            running.clear();
+        }
+    }
+
+    TimerWheel wheel;
+    std::vector<Task> ready, running;
+    std::chrono::milliseconds tickLength;
+    std::chrono::steady_clock::time_point start;
+};
+
+// -----------------------------
+// The usual alternative: a binary heap, cancellation by tombstone
+// -----------------------------
+class HeapTimers {
+public:
+    using Callback = std::function<void()>;
+
+    std::uint32_t schedule(std::uint64_t delay, Callback cb) {
+        std::uint32_t id = static_cast<std::uint32_t>(callbacks.size());
+        callbacks.push_back(std::move(cb));
+        heap.push({ currentTick + (delay ? delay : 1), id });
+        return id;
+    }
+
+    void cancel(std::uint32_t id) { callbacks[id] = nullptr; } // stays in the heap until popped
+
+    std::size_t advanceTo(std::uint64_t tick) {
+        std::size_t fired = 0;
+        currentTick = tick;
+        while (!heap.empty() && heap.top().expiry <= tick) {
+            std::uint32_t id = heap.top().id;
+            heap.pop();
+            if (callbacks[id]) {
+                callbacks[id]();
+                callbacks[id] = nullptr;
+                ++fired;
+            }
+        }
+        return fired;
+    }
+
+private:
+    struct Entry {
+        std::uint64_t expiry;
+        std::uint32_t id;
+        bool operator>(const Entry& o) const { return expiry > o.expiry; }
+    };
+
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+    std::vector<Callback> callbacks;
+    std::uint64_t currentTick = 0;
+};
+
+int main() {
+    std::cout << "=== Delayed, periodic and cancelled tasks (1 tick = 1 ms) ===\n";
+    EventLoop loop;
+    int retries = 0;
+
+    loop.post([&] { std::cout << "[t=" << loop.now() << "] immediate task, as in 11_stdFunction_2\n"; });
+    loop.after(250, [&] { std::cout << "[t=" << loop.now() << "] timeout after 250 ticks\n"; });
+    TimerHandle retry{};
+    retry = loop.every(100, [&] {
+        std::cout << "[t=" << loop.now() << "] retry #" << ++retries << "\n";
+        if (retries == 3) loop.cancel(retry); // a periodic timer cancelling itself
+        });
+    TimerHandle never = loop.after(200, [] { std::cout << "never printed\n"; });
+    loop.after(150, [&] {
+        std::cout << "[t=" << loop.now() << "] cancelling the 200-tick timer: " << (loop.cancel(never) ? "ok" : "failed") << "\n";
+        loop.post([&] { std::cout << "[t=" << loop.now() << "] follow-up posted by a timer\n"; });
+        });
+    loop.after(70'000, [&] { std::cout << "[t=" << loop.now() << "] long timer, cascaded down from an outer wheel\n"; });
+    loop.runTicks(70'000);
+
+    // -----------------------------
+    // Benchmark: 1M pending timers
+    // -----------------------------
+    const std::size_t N = 1'000'000;
+    const std::uint64_t horizon = 60'000; // delays up to one minute at 1 ms per tick
+    std::mt19937_64 rng(42);
+    std::vector<std::uint64_t> delays(N);
+    for (auto& d : delays) d = 1 + rng() % horizon;
+
+    long long firedWheel = 0, firedHeap = 0;
+    TimerWheel wheel;
+    HeapTimers heap;
+    std::vector<TimerHandle> wheelHandles(N);
+    std::vector<std::uint32_t> heapIds(N);
+
+    auto time = [](auto body) {
+        auto s = std::chrono::high_resolution_clock::now();
+        body();
+        auto e = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double>(e - s).count();
+    };
+
+    double wInsert = time([&] { for (std::size_t i = 0; i < N; ++i) wheelHandles[i] = wheel.schedule(delays[i], [&firedWheel] { ++firedWheel; }); });
+    double hInsert = time([&] { for (std::size_t i = 0; i < N; ++i) heapIds[i] = heap.schedule(delays[i], [&firedHeap] { ++firedHeap; }); });
+
+    // Most timeouts never fire: cancel every other one
+    double wCancel = time([&] { for (std::size_t i = 0; i < N; i += 2) wheel.cancel(wheelHandles[i]); });
+    double hCancel = time([&] { for (std::size_t i = 0; i < N; i += 2) heap.cancel(heapIds[i]); });
+
+    // Tick by tick, as an event loop would
+    double wExpire = time([&] { for (std::uint64_t t = 1; t <= horizon; ++t) wheel.advanceTo(t); });
+    double hExpire = time([&] { for (std::uint64_t t = 1; t <= horizon; ++t) heap.advanceTo(t); });
+
+    auto ns = [&](double s, std::size_t ops) { return s / ops * 1e9; };
+    std::cout << "\n=== " << N << " timers over " << horizon << " ticks, half cancelled ===\n";
+    std::cout << "                 timer wheel   priority_queue   (ns per timer)\n";
+    std::cout << "schedule         " << ns(wInsert, N) << "\t" << ns(hInsert, N) << "\n";
+    std::cout << "cancel           " << ns(wCancel, N / 2) << "\t" << ns(hCancel, N / 2) << "  (heap: tombstone, removed on pop)\n";
+    std::cout << "advance + fire   " << ns(wExpire, N / 2) << "\t" << ns(hExpire, N / 2) << "\n";
+    std::cout << "Fired " << firedWheel << " / " << firedHeap << " (expected " << N / 2 << "), "
+        << (firedWheel == firedHeap && firedWheel == static_cast<long long>(N / 2) ? "match" : "DIFFER") << "\n";
+
+    return 0;
+}
@@ -0,0 +1,411 @@
+// -----------------------------
+// C++20 coroutines on the event loop of 11_stdFunction_2
+// -----------------------------
+// - task<T>: a lazy coroutine; co_await it from another task to run it and
+//   get its result (or its exception)
+// - co_await yield():         back to the end of the loop's queue
+// - co_await sleep_for(d):    resumed by the loop once d has passed
+// - resuming is just another std::function<void()> in the same queue; it
+//   captures only the coroutine handle, so it fits std::function's small buffer
+// - coroutine frames come from a size-class free-list pool: after warm-up,
+//   suspending, resuming and starting tasks allocate nothing
+// The loop and the pool are single-threaded.
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <functional>
+#include <coroutine>
+#include <optional>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+#include <thread>
+#include <new>
+#include <cstdlib>
+#include <chrono>
+
+using namespace std::chrono_literals;
+
+// -----------------------------
+// Global new/delete overrides: count instead of printing
+// -----------------------------
+static std::size_t g_allocations = 0;
+
+void* operator new(std::size_t n) noexcept(false) {
+    if (n == 0) n = 1;
+    void* p = std::malloc(n);
+    if (!p) throw std::bad_alloc();
+    ++g_allocations;
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+// -----------------------------
+// Frame pool
+// -----------------------------
+// Frames are rounded up to 64-byte classes; freed frames go on a per-class
+// free list and are reused. Frames over 2 KiB use the global heap.
+class FramePool {
+public:
+    static void* allocate(std::size_t n) {
+        std::size_t c = classOf(n);
+        if (c >= Classes) return ::operator new(n);
+        if (FreeBlock* b = freeLists[c]) {
+            freeLists[c] = b->next;
+            return b;
+        }
+        return ::operator new((c + 1) * Granule);
+    }
+
+    static void deallocate(void* p, std::size_t n) {
+        std::size_t c = classOf(n);
+        if (c >= Classes) {
+            ::operator delete(p);
+            return;
+        }
+        FreeBlock* b = static_cast<FreeBlock*>(p);
+        b->next = freeLists[c];
+        freeLists[c] = b;
+    }
+
+private:
+    static constexpr std::size_t Granule = 64;
+    static constexpr std::size_t Classes = 32;
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    static std::size_t classOf(std::size_t n) { return (n + Granule - 1) / Granule - 1; }
+
+    static inline FreeBlock* freeLists[Classes] = {};
+};
+
+// Promise types derive from this: the compiler allocates their frames through it
+struct PooledFrame {
+    static void* operator new(std::size_t n) { return FramePool::allocate(n); }
+    static void operator delete(void* p, std::size_t n) noexcept { FramePool::deallocate(p, n); }
+};
+
+// -----------------------------
+// task<T>
+// -----------------------------
+template <typename T = void>
+class task;
+
+namespace detail {
+
+struct PromiseBase : PooledFrame {
+    std::coroutine_handle<> continuation = std::noop_coroutine();
+    std::exception_ptr error;
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    // Finishing resumes whoever awaited us, without growing the stack
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+        template <typename P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept { return h.promise().continuation; }
+        void await_resume() noexcept {}
+    };
+    FinalAwaiter final_suspend() noexcept { return {}; }
+
+    void unhandled_exception() { error = std::current_exception(); }
+};
+
+template <typename T>
+struct Promise : PromiseBase {
+    std::optional<T> value;
+
+    task<T> get_return_object();
+    template <typename U>
+    void return_value(U&& v) { value.emplace(std::forward<U>(v)); }
+
+    T result() {
+        if (error) std::rethrow_exception(error);
+        return std::move(*value);
+    }
+};
+
+template <>
+struct Promise<void> : PromiseBase {
+    task<void> get_return_object();
+    void return_void() {}
+
+    void result() {
+        if (error) std::rethrow_exception(error);
+    }
+};
+
+} // namespace detail
+
+template <typename T>
+class task {
+public:
+    using promise_type = detail::Promise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    explicit task(Handle h) : handle(h) {}
+    task(task&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    task& operator=(task&& other) noexcept {
+        if (this != &other) {
+            if (handle) handle.destroy();
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+    task(const task&) = delete;
+    task& operator=(const task&) = delete;
+    ~task() {
+        if (handle) handle.destroy();
+    }
+
+    // co_await starts the task and resumes the awaiter when it finishes
+    auto operator co_await() noexcept {
+        struct Awaiter {
+            Handle h;
+            bool await_ready() noexcept { return !h || h.done(); }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                h.promise().continuation = awaiting;
+                return h; // symmetric transfer: start the task right away
+            }
+            T await_resume() { return h.promise().result(); }
+        };
+        return Awaiter{ handle };
+    }
+
+private:
+    Handle handle;
+};
+
+namespace detail {
+template <typename T>
+task<T> Promise<T>::get_return_object() { return task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this)); }
+inline task<void> Promise<void>::get_return_object() { return task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this)); }
+} // namespace detail
+
+// -----------------------------
+// Event loop
+// -----------------------------
+class EventLoop {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    void post(std::function<void()> f) { ready.push_back(std::move(f)); }
+    void resumeLater(std::coroutine_handle<> h) { post([h] { h.resume(); }); }
+    void resumeAt(Clock::time_point when, std::coroutine_handle<> h) { timers.push({ when, sequence++, h }); }
+
+    // Runs the task to completion on this loop; the loop owns it meanwhile
+    void spawn(task<void> t) {
+        ++active;
+        runDetached(*this, std::move(t));
+    }
+
+    // Until no task is queued, sleeping or running. Rethrows the first
+    // exception that escaped a spawned task.
+    void run() {
+        EventLoop* previous = std::exchange(currentLoop, this);
+        while (!ready.empty() || !timers.empty()) {
+            while (!ready.empty()) {
+                running.swap(ready);
+                for (auto& f : running) f();
+                running.clear();
+            }
+            if (timers.empty()) break;
+            std::this_thread::sleep_until(timers.top().when);
+            Clock::time_point now = Clock::now();
+            while (!timers.empty() && timers.top().when <= now) {
+                resumeLater(timers.top().handle);
+                timers.pop();
+            }
+        }
+        currentLoop = previous;
+        if (firstError) std::rethrow_exception(std::exchange(firstError, nullptr));
+    }
+
+    int activeTasks() const { return active; }
+
+    static EventLoop& current() { return *currentLoop; }
+
+private:
+    // Fire-and-forget coroutine: starts suspended in the queue, frees itself at the end
+    struct Detached {
+        struct promise_type : PooledFrame {
+            Detached get_return_object() { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); } // runDetached catches everything
+        };
+    };
+
+    struct Schedule {
+        EventLoop* loop;
+        bool await_ready() noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) { loop->resumeLater(h); }
+        void await_resume() noexcept {}
+    };
+
+    static Detached runDetached(EventLoop& loop, task<void> t) {
+        co_await Schedule{ &loop };
+        try {
+            co_await t;
+        }
+        catch (...) {
+            if (!loop.firstError) loop.firstError = std::current_exception();
+        }
+        --loop.active;
+    }
+
+    struct Timer {
+        Clock::time_point when;
+        unsigned long long sequence; // equal deadlines resume in scheduling order
+        std::coroutine_handle<> handle;
+        bool operator>(const Timer& o) const { return when != o.when ? when > o.when : sequence > o.sequence; }
+    };
+
+    std::vector<std::function<void()>> ready, running;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers;
+    unsigned long long sequence = 0;
+    int active = 0;
+    std::exception_ptr firstError;
+
+    static inline thread_local EventLoop* currentLoop = nullptr;
+};
+
+// -----------------------------
+// Awaitables
+// -----------------------------
+inline auto yield() {
+    struct Awaiter {
+        bool await_ready() noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) { EventLoop::current().resumeLater(h); }
+        void await_resume() noexcept {}
+    };
+    return Awaiter{};
+}
+
+inline auto sleep_for(EventLoop::Clock::duration d) {
+    struct Awaiter {
+        EventLoop::Clock::duration d;
+        bool await_ready() noexcept { return d <= EventLoop::Clock::duration::zero(); }
+        void await_suspend(std::coroutine_handle<> h) { EventLoop::current().resumeAt(EventLoop::Clock::now() + d, h); }
+        void await_resume() noexcept {}
+    };
+    return Awaiter{ d };
+}
+
+// -----------------------------
+// Demo tasks
+// -----------------------------
+task<int> addLater(int x, int y) {
+    co_await sleep_for(20ms);
+    co_return x + y;
+}
+
+task<int> failing() {
+    co_await yield();
+    throw std::runtime_error("division by zero");
+}
+
+task<void> worker(int id, int value) {
+    std::cout << "[Worker " << id << "] Processing value: " << value << "\n";
+    co_await yield(); // let the other worker run
+    std::cout << "[Worker " << id << "] squared = " << value * value << "\n";
+}
+
+task<void> demo() {
+    std::cout << "[demo] starting, sleeping 10 ms\n";
+    co_await sleep_for(10ms);
+    int sum = co_await addLater(3, 4);
+    std::cout << "[demo] addLater(3, 4) = " << sum << " after 20 ms more\n";
+    try {
+        co_await failing();
+    }
+    catch (const std::exception& e) {
+        std::cout << "[demo] caught from an awaited task: " << e.what() << "\n";
+    }
+}
+
+// -----------------------------
+// Benchmark: many sessions taking turns
+// -----------------------------
+struct SessionState {
+    long long acc;
+    long long a, b, c;
+    int step;
+};
+
+// Callback style: each step re-posts a closure carrying the whole state
+void callbackStep(EventLoop& loop, SessionState s, int steps, long long& total) {
+    s.acc += s.a * s.step + s.b - s.c;
+    if (++s.step == steps) {
+        total += s.acc;
+        return;
+    }
+    loop.post([&loop, s, steps, &total] { callbackStep(loop, s, steps, total); }); // too large for the small buffer
+}
+
+// Coroutine style: the state stays in the suspended frame
+task<void> session(long long id, int steps, long long& total) {
+    SessionState s{ 0, id, 3, 1, 0 };
+    while (s.step < steps) {
+        s.acc += s.a * s.step + s.b - s.c;
+        if (++s.step == steps) break;
+        co_await yield();
+    }
+    total += s.acc;
+}
+
+int main() {
+    std::cout << "=== Coroutine tasks on the event loop ===\n";
+    EventLoop loop;
+    loop.post([] { std::cout << "[callback] a plain std::function task still works\n"; });
+    loop.spawn(demo());
+    loop.spawn(worker(1, 5));
+    loop.spawn(worker(2, 8));
+    loop.run();
+    std::cout << "Tasks still active: " << loop.activeTasks() << "\n";
+
+    const int sessions = 10'000;
+    const int steps = 100;
+
+    long long callbackTotal = 0;
+    std::size_t before = g_allocations;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < sessions; ++i) {
+        loop.post([&loop, i, &callbackTotal] { callbackStep(loop, SessionState{ 0, i, 3, 1, 0 }, steps, callbackTotal); });
+    }
+    loop.run();
+    auto end = std::chrono::high_resolution_clock::now();
+    std::size_t callbackAllocs = g_allocations - before;
+    double tCallback = std::chrono::duration<double>(end - start).count();
+
+    // First round warms the frame pool and the queue capacity; the second is measured
+    long long coroTotal = 0;
+    for (int round = 0; round < 2; ++round) {
+        coroTotal = 0;
+        before = g_allocations;
+        start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < sessions; ++i) loop.spawn(session(i, steps, coroTotal));
+        loop.run();
+        end = std::chrono::high_resolution_clock::now();
+    }
+    std::size_t coroAllocs = g_allocations - before;
+    double tCoro = std::chrono::duration<double>(end - start).count();
+
+    double resumes = double(sessions) * steps;
+    std::cout << "\n=== " << sessions << " sessions x " << steps << " steps ===\n";
+    std::cout << "Nested std::function callbacks: " << resumes / tCallback / 1e6 << " M steps/s, " << callbackAllocs << " allocations\n";
+    std::cout << "Coroutines (pooled frames):     " << resumes / tCoro / 1e6 << " M steps/s, " << coroAllocs << " allocations\n";
+    std::cout << "Results " << (callbackTotal == coroTotal ? "match" : "DIFFER") << "\n";
+
+    return 0;
+}
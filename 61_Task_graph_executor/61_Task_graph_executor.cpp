@@ -0,0 +1,417 @@
+// -----------------------------
+// Task graph: ordering by dependencies instead of push order
+// -----------------------------
+// The event queue of 11_stdFunction_2 runs tasks in the order they were
+// pushed. A TaskGraph instead declares tasks and "a before b" edges:
+// - each task has a counter of unfinished predecessors; finishing a task
+//   decrements its successors' counters with one atomic fetch_sub, and a task
+//   whose counter reaches zero is ready
+// - the first successor made ready runs right away on the same thread, the
+//   others go to a shared ready queue served by the executor's threads
+// - the graph is checked for cycles once; every later run only resets the
+//   counters, so re-running it each frame allocates nothing
+// - each run records per-task start times and durations, from which the
+//   critical path (the longest chain of dependent work) is computed
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <chrono>
+
+// -----------------------------
+// Global new/delete overrides: count instead of printing
+// -----------------------------
+static std::atomic<std::size_t> g_allocations{ 0 };
+
+void* operator new(std::size_t n) noexcept(false) {
+    if (n == 0) n = 1;
+    void* p = std::malloc(n);
+    if (!p) throw std::bad_alloc();
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+using Clock = std::chrono::steady_clock;
+
+// -----------------------------
+// Task graph
+// -----------------------------
+class TaskGraph {
+public:
+    using TaskId = std::uint32_t;
+
+    TaskId emplace(std::string name, std::function<void()> work) {
+        nodes.push_back({ std::move(name), std::move(work), {}, 0, 0, 0 });
+        prepared = false;
+        return static_cast<TaskId>(nodes.size() - 1);
+    }
+
+    // `after` starts only once `before` has finished
+    void precede(TaskId before, TaskId after) {
+        if (before >= nodes.size() || after >= nodes.size()) throw std::out_of_range("TaskGraph::precede: unknown task");
+        nodes[before].successors.push_back(after);
+        ++nodes[after].predecessors;
+        prepared = false;
+    }
+
+    std::size_t size() const { return nodes.size(); }
+    const std::string& name(TaskId id) const { return nodes[id].name; }
+
+    // Timings of the last run, relative to its start
+    Clock::duration startTime(TaskId id) const { return Clock::duration(nodes[id].startNs); }
+    Clock::duration duration(TaskId id) const { return Clock::duration(nodes[id].endNs - nodes[id].startNs); }
+
+    struct CriticalPath {
+        std::vector<TaskId> tasks; // in execution order
+        Clock::duration length{};  // sum of their durations
+        Clock::duration work{};    // sum of all durations
+    };
+
+    // Longest chain of dependent tasks in the last run, weighted by duration
+    CriticalPath criticalPath() const {
+        CriticalPath path;
+        if (nodes.empty()) return path;
+        std::vector<long long> finish(nodes.size());
+        std::vector<TaskId> parent(nodes.size(), None);
+        for (TaskId id : order) finish[id] = nodes[id].endNs - nodes[id].startNs;
+        for (TaskId id : order) {
+            path.work += duration(id);
+            for (TaskId s : nodes[id].successors) {
+                long long candidate = finish[id] + (nodes[s].endNs - nodes[s].startNs);
+                if (candidate > finish[s]) {
+                    finish[s] = candidate;
+                    parent[s] = id;
+                }
+            }
+        }
+        TaskId last = static_cast<TaskId>(std::max_element(finish.begin(), finish.end()) - finish.begin());
+        path.length = Clock::duration(finish[last]);
+        for (TaskId id = last; id != None; id = parent[id]) path.tasks.push_back(id);
+        std::reverse(path.tasks.begin(), path.tasks.end());
+        return path;
+    }
+
+    void printTimings(std::ostream& os) const {
+        auto ms = [](Clock::duration d) { return std::chrono::duration<double, std::milli>(d).count(); };
+        os << std::fixed << std::setprecision(3);
+        for (TaskId id : order) {
+            os << "  " << std::left << std::setw(12) << nodes[id].name << std::right
+                << " start " << std::setw(8) << ms(startTime(id)) << " ms, took " << std::setw(8) << ms(duration(id)) << " ms\n";
+        }
+        CriticalPath path = criticalPath();
+        os << "  Critical path:";
+        for (TaskId id : path.tasks) os << " " << nodes[id].name;
+        os << "\n  Critical path " << ms(path.length) << " ms, total work " << ms(path.work) << " ms, parallelism "
+            << (path.length.count() ? double(path.work.count()) / path.length.count() : 0.0) << "\n";
+        os << std::defaultfloat;
+    }
+
+private:
+    friend class GraphExecutor;
+
+    static constexpr TaskId None = ~TaskId(0);
+
+    struct Node {
+        std::string name;
+        std::function<void()> work;
+        std::vector<TaskId> successors;
+        int predecessors;
+        long long startNs, endNs;
+    };
+
+    // Once per change of shape: topological order (rejecting cycles) and the
+    // counters' storage. Later runs reuse both.
+    void prepare() {
+        if (prepared) return;
+        std::vector<int> indegree(nodes.size());
+        roots.clear();
+        order.clear();
+        for (TaskId id = 0; id < nodes.size(); ++id) {
+            indegree[id] = nodes[id].predecessors;
+            if (indegree[id] == 0) roots.push_back(id);
+        }
+        order = roots;
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            for (TaskId s : nodes[order[i]].successors) {
+                if (--indegree[s] == 0) order.push_back(s);
+            }
+        }
+        if (order.size() != nodes.size()) throw std::logic_error("TaskGraph: dependency cycle");
+        remaining = std::make_unique<std::atomic<int>[]>(nodes.size());
+        prepared = true;
+    }
+
+    std::vector<Node> nodes;
+    std::vector<TaskId> roots;
+    std::vector<TaskId> order;
+    std::unique_ptr<std::atomic<int>[]> remaining;
+    bool prepared = false;
+};
+
+// -----------------------------
+// Executor
+// -----------------------------
+class GraphExecutor {
+public:
+    using TaskId = TaskGraph::TaskId;
+
+    // `threads` workers plus the thread calling run()
+    explicit GraphExecutor(unsigned threads = std::max(1u, std::thread::hardware_concurrency()) - 1) {
+        for (unsigned i = 0; i < threads; ++i) workers.emplace_back([this] { workerLoop(); });
+    }
+
+    GraphExecutor(const GraphExecutor&) = delete;
+    GraphExecutor& operator=(const GraphExecutor&) = delete;
+
+    ~GraphExecutor() {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            stop = true;
+        }
+        cv.notify_all();
+        for (auto& t : workers) t.join();
+    }
+
+    // Runs every task once, respecting the edges, and returns when all are
+    // done. After a task throws, the tasks not yet started are skipped and
+    // the first exception is rethrown here.
+    void run(TaskGraph& g) {
+        g.prepare();
+        if (g.nodes.empty()) return;
+        {
+            std::lock_guard<std::mutex> lock(m);
+            graph = &g;
+            total = g.nodes.size();
+            completed.store(0, std::memory_order_relaxed);
+            failed.store(false, std::memory_order_relaxed);
+            error = nullptr;
+            if (ready.size() < total) ready.resize(total); // every task is queued at most once
+            head = tail = 0;
+            for (TaskId id = 0; id < total; ++id) g.remaining[id].store(g.nodes[id].predecessors, std::memory_order_relaxed);
+            for (TaskId id : g.roots) ready[tail++] = id;
+            runStart = Clock::now();
+        }
+        cv.notify_all();
+
+        // The caller helps until the last task has finished
+        for (;;) {
+            std::unique_lock<std::mutex> lock(m);
+            cv.wait(lock, [this] { return head != tail || completed.load() == total; });
+            if (completed.load() == total) break;
+            TaskId id = ready[head++];
+            lock.unlock();
+            runChain(id);
+        }
+        graph = nullptr;
+        if (error) std::rethrow_exception(error);
+    }
+
+    std::size_t threadCount() const { return workers.size() + 1; }
+
+private:
+    void workerLoop() {
+        for (;;) {
+            TaskId id;
+            {
+                std::unique_lock<std::mutex> lock(m);
+                cv.wait(lock, [this] { return stop || head != tail; });
+                if (stop) return;
+                id = ready[head++];
+            }
+            runChain(id);
+        }
+    }
+
+    // Runs a task, then keeps going with the first successor it made ready
+    void runChain(TaskId id) {
+        TaskGraph& g = *graph;
+        const std::size_t count = total; // read before our last fetch_add: the next run() may reset it right after
+        while (id != TaskGraph::None) {
+            TaskGraph::Node& node = g.nodes[id];
+            node.startNs = (Clock::now() - runStart).count();
+            if (!failed.load(std::memory_order_relaxed)) {
+                try {
+                    node.work();
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> lock(m);
+                    if (!error) error = std::current_exception();
+                    failed.store(true, std::memory_order_relaxed);
+                }
+            }
+            node.endNs = (Clock::now() - runStart).count();
+
+            TaskId next = TaskGraph::None;
+            for (TaskId s : node.successors) {
+                if (g.remaining[s].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    if (next == TaskGraph::None) next = s;
+                    else push(s);
+                }
+            }
+            if (completed.fetch_add(1, std::memory_order_acq_rel) + 1 == count) {
+                { std::lock_guard<std::mutex> lock(m); } // run() is either waiting or will see the count
+                cv.notify_all();
+            }
+            id = next;
+        }
+    }
+
+    void push(TaskId id) {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            ready[tail++] = id;
+        }
+        cv.notify_one();
+    }
+
+    std::mutex m;
+    std::condition_variable cv;
+    std::vector<TaskId> ready; // head..tail are queued; sized to the graph
+    std::size_t head = 0;
+    std::size_t tail = 0;
+    TaskGraph* graph = nullptr;
+    std::size_t total = 0;
+    std::atomic<std::size_t> completed{ 0 };
+    std::atomic<bool> failed{ false };
+    std::exception_ptr error;
+    Clock::time_point runStart;
+    bool stop = false;
+    std::vector<std::thread> workers;
+};
+
+// -----------------------------
+// Demo: one frame of a game loop
+// -----------------------------
+void busyWork(std::chrono::microseconds d) {
+    auto until = Clock::now() + d;
+    while (Clock::now() < until) {}
+}
+
+// Benchmark graph: `width` columns, `depth` layers; each node combines two
+// nodes of the previous layer
+void buildLayered(TaskGraph& g, std::vector<long long>& values, int width, int depth) {
+    values.assign(std::size_t(width) * depth, 0);
+    for (int layer = 0; layer < depth; ++layer) {
+        for (int col = 0; col < width; ++col) {
+            int i = layer * width + col;
+            if (layer == 0) {
+                g.emplace("seed", [&values, i] { values[i] = i; });
+                continue;
+            }
+            int a = (layer - 1) * width + col;
+            int b = (layer - 1) * width + (col + 1) % width;
+            TaskGraph::TaskId id = g.emplace("mix", [&values, i, a, b] { values[i] = (values[a] * 31 + values[b]) % 1'000'003; });
+            g.precede(a, id);
+            g.precede(b, id);
+        }
+    }
+}
+
+int main() {
+    std::cout << "=== One frame as a task graph ===\n";
+    GraphExecutor executor;
+    std::cout << "Executor threads: " << executor.threadCount() << "\n";
+
+    TaskGraph frame;
+    auto work = [](std::chrono::microseconds d) { return [d] { busyWork(d); }; };
+    auto input = frame.emplace("input", work(std::chrono::microseconds(200)));
+    auto physics = frame.emplace("physics", work(std::chrono::microseconds(1500)));
+    auto animation = frame.emplace("animation", work(std::chrono::microseconds(800)));
+    auto audio = frame.emplace("audio", work(std::chrono::microseconds(400)));
+    auto collision = frame.emplace("collision", work(std::chrono::microseconds(700)));
+    auto render = frame.emplace("render", work(std::chrono::microseconds(1200)));
+    auto present = frame.emplace("present", work(std::chrono::microseconds(100)));
+    frame.precede(input, physics);
+    frame.precede(input, animation);
+    frame.precede(input, audio);
+    frame.precede(physics, collision);
+    frame.precede(collision, render);
+    frame.precede(animation, render);
+    frame.precede(render, present);
+    frame.precede(audio, present);
+    executor.run(frame);
+    frame.printTimings(std::cout);
+
+    // Cycles are rejected before anything runs
+    TaskGraph cyclic;
+    auto a = cyclic.emplace("a", [] {});
+    auto b = cyclic.emplace("b", [] {});
+    cyclic.precede(a, b);
+    cyclic.precede(b, a);
+    try {
+        executor.run(cyclic);
+    }
+    catch (const std::logic_error& e) {
+        std::cout << "\nCyclic graph: " << e.what() << "\n";
+    }
+
+    // A throwing task: the rest of the run is skipped, the exception surfaces in run()
+    TaskGraph failing;
+    auto load = failing.emplace("load", [] { throw std::runtime_error("asset missing"); });
+    auto use = failing.emplace("use", [] { std::cout << "not reached\n"; });
+    failing.precede(load, use);
+    try {
+        executor.run(failing);
+    }
+    catch (const std::exception& e) {
+        std::cout << "Failing graph: " << e.what() << "\n";
+    }
+
+    // -----------------------------
+    // Benchmark: re-run one graph vs rebuild it every frame
+    // -----------------------------
+    const int width = 32;
+    const int depth = 16;
+    const int frames = 500;
+
+    std::vector<long long> values;
+    TaskGraph reused;
+    buildLayered(reused, values, width, depth);
+    executor.run(reused); // warm-up: prepares the graph and sizes the ready queue
+
+    std::size_t before = g_allocations.load();
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int f = 0; f < frames; ++f) executor.run(reused);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::size_t reusedAllocs = g_allocations.load() - before;
+    double tReused = std::chrono::duration<double>(end - start).count();
+    long long reusedResult = values.back();
+
+    before = g_allocations.load();
+    start = std::chrono::high_resolution_clock::now();
+    for (int f = 0; f < frames; ++f) {
+        TaskGraph fresh;
+        buildLayered(fresh, values, width, depth);
+        executor.run(fresh);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::size_t freshAllocs = g_allocations.load() - before;
+    double tFresh = std::chrono::duration<double>(end - start).count();
+
+    std::cout << "\n=== " << width * depth << " tasks x " << frames << " frames ===\n";
+    std::cout << "Rebuilt every frame: " << tFresh / frames * 1e6 << " us/frame, " << freshAllocs << " allocations\n";
+    std::cout << "Reused graph:        " << tReused / frames * 1e6 << " us/frame, " << reusedAllocs << " allocations\n";
+    std::cout << "Results " << (reusedResult == values.back() ? "match" : "DIFFER") << "\n";
+
+    return 0;
+}
@@ -0,0 +1,478 @@
+// -----------------------------
+// epoll reactor: the event loop of 11_stdFunction_2 waiting on file descriptors
+// -----------------------------
+// - post(): the same queue of std::function<void()> tasks
+// - watch(fd, onReadable, onWritable): callbacks run when epoll reports the
+//   fd ready (pipes, sockets, eventfd, ...); level-triggered
+// - while the queue has tasks, epoll is only polled; when it is empty the
+//   loop blocks in epoll_wait
+// - postFromAnyThread()/stop(): other threads append to an inbox and wake the
+//   loop by writing to an eventfd; a write is only needed while no wakeup is
+//   already pending
+// - Connection: a nonblocking stream socket with an output buffer, using the
+//   write callback only while the kernel buffer is full; writing to a peer
+//   that has gone away closes the connection (MSG_NOSIGNAL: no SIGPIPE)
+// Linux only (epoll, eventfd).
+#include <iostream>
+
+#if defined(__linux__)
+#include <vector>
+#include <array>
+#include <span>
+#include <unordered_map>
+#include <memory>
+#include <functional>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <system_error>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <cerrno>
+#include <chrono>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+[[noreturn]] void throwErrno(const char* what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+// -----------------------------
+// Reactor
+// -----------------------------
+class Reactor {
+public:
+    using Callback = std::function<void()>;
+
+    Reactor() {
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        if (epollFd < 0) throwErrno("epoll_create1");
+        wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wakeFd < 0) {
+            close(epollFd);
+            throwErrno("eventfd");
+        }
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.ptr = nullptr; // the wakeup fd: no Watch
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &ev) < 0) {
+            close(wakeFd);
+            close(epollFd);
+            throwErrno("epoll_ctl(wake)");
+        }
+    }
+
+    Reactor(const Reactor&) = delete;
+    Reactor& operator=(const Reactor&) = delete;
+
+    ~Reactor() {
+        close(wakeFd);
+        close(epollFd);
+    }
+
+    // Loop thread only
+    void post(Callback f) { ready.push_back(std::move(f)); }
+
+    // Any thread
+    void postFromAnyThread(Callback f) {
+        bool signal;
+        {
+            std::lock_guard<std::mutex> lock(inboxMutex);
+            inbox.push_back(std::move(f));
+            signal = !wakePending;
+            wakePending = true;
+        }
+        if (signal) wake();
+    }
+
+    // Any thread: run() returns after the current iteration
+    void stop() {
+        stopping.store(true);
+        wake();
+    }
+
+    // The fd stays owned by the caller; unwatch it before closing it.
+    // Hang-ups and errors are reported to both callbacks that exist, which
+    // should then unwatch the fd; a watch with neither is removed.
+    void watch(int fd, Callback onReadable, Callback onWritable = {}) {
+        auto w = std::make_unique<Watch>(Watch{ fd, 0, std::move(onReadable), std::move(onWritable), true });
+        w->events = (w->onRead ? EPOLLIN : 0u) | (w->onWrite ? EPOLLOUT : 0u);
+        epoll_event ev{};
+        ev.events = w->events;
+        ev.data.ptr = w.get();
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) < 0) throwErrno("epoll_ctl(add)");
+        watches[fd] = std::move(w);
+    }
+
+    // Turns the interest in writability on or off (the callback is kept)
+    void setWritable(int fd, Callback onWritable) {
+        Watch& w = *watches.at(fd);
+        w.onWrite = std::move(onWritable);
+        std::uint32_t events = (w.onRead ? EPOLLIN : 0u) | (w.onWrite ? EPOLLOUT : 0u);
+        if (events == w.events) return;
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.ptr = &w;
+        if (epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &ev) < 0) throwErrno("epoll_ctl(mod)");
+        w.events = events;
+    }
+
+    // Safe from inside the fd's own callback: the Watch is freed after the
+    // current batch of events, and its pending events are ignored
+    void unwatch(int fd) {
+        auto it = watches.find(fd);
+        if (it == watches.end()) return;
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        it->second->active = false;
+        retired.push_back(std::move(it->second));
+        watches.erase(it);
+    }
+
+    // Until stop()
+    void run() {
+        while (!stopping.load()) {
+            while (!ready.empty()) {
+                running.swap(ready);
+                for (auto& f : running) f();
+                running.clear();
+                if (stopping.load()) break;
+            }
+            if (stopping.load()) break;
+            int n = epoll_wait(epollFd, events.data(), static_cast<int>(events.size()), ready.empty() ? -1 : 0);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                throwErrno("epoll_wait");
+            }
+            for (int i = 0; i < n; ++i) {
+                Watch* w = static_cast<Watch*>(events[i].data.ptr);
+                if (!w) {
+                    drainInbox();
+                    continue;
+                }
+                std::uint32_t e = events[i].events;
+                bool hangup = e & (EPOLLHUP | EPOLLERR);
+                if ((e & EPOLLIN || hangup) && w->active && w->onRead) w->onRead();
+                if ((e & EPOLLOUT || hangup) && w->active && w->onWrite) w->onWrite();
+                if (hangup && w->active && !w->onRead && !w->onWrite) unwatch(w->fd); // would be reported forever
+            }
+            retired.clear();
+        }
+        stopping.store(false);
+    }
+
+    std::size_t wakeups() const { return wakeupCount; }
+
+private:
+    struct Watch {
+        int fd;
+        std::uint32_t events;
+        Callback onRead;
+        Callback onWrite;
+        bool active;
+    };
+
+    void wake() {
+        std::uint64_t one = 1;
+        ssize_t r = write(wakeFd, &one, sizeof one);
+        (void)r; // only fails if the counter is saturated, which still wakes the loop
+    }
+
+    void drainInbox() {
+        std::uint64_t count;
+        ssize_t r = read(wakeFd, &count, sizeof count);
+        (void)r;
+        ++wakeupCount;
+        std::lock_guard<std::mutex> lock(inboxMutex);
+        wakePending = false;
+        for (auto& f : inbox) ready.push_back(std::move(f));
+        inbox.clear();
+    }
+
+    int epollFd = -1;
+    int wakeFd = -1;
+    std::vector<Callback> ready, running;
+    std::unordered_map<int, std::unique_ptr<Watch>> watches;
+    std::vector<std::unique_ptr<Watch>> retired;
+    std::array<epoll_event, 64> events{};
+
+    std::mutex inboxMutex;
+    std::vector<Callback> inbox;
+    bool wakePending = false;
+    std::atomic<bool> stopping{ false };
+    std::size_t wakeupCount = 0;
+};
+
+// -----------------------------
+// Connection: buffered nonblocking stream
+// -----------------------------
+class Connection {
+public:
+    using DataHandler = std::function<void(Connection&, std::span<const char>)>;
+
+    // Takes ownership of a stream socket fd (made nonblocking here)
+    Connection(Reactor& reactor, int fd, DataHandler onData) : reactor(reactor), fd(fd), onData(std::move(onData)), inBuf(64 * 1024) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        reactor.watch(fd, [this] { readable(); });
+    }
+
+    Connection(const Connection&) = delete;
+    Connection& operator=(const Connection&) = delete;
+
+    ~Connection() { close(); }
+
+    void send(std::span<const char> data) {
+        if (fd < 0) return;
+        std::size_t done = 0;
+        if (outBuf.empty()) {
+            ssize_t n = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+            if (n < 0 && errno != EAGAIN) {
+                close(); // EPIPE, ECONNRESET, ...: the peer is gone
+                return;
+            }
+            done = n > 0 ? static_cast<std::size_t>(n) : 0;
+        }
+        if (done < data.size()) {
+            bool wasEmpty = outBuf.empty();
+            outBuf.insert(outBuf.end(), data.begin() + done, data.end());
+            if (wasEmpty) reactor.setWritable(fd, [this] { writable(); });
+        }
+    }
+
+    void close() {
+        if (fd < 0) return;
+        reactor.unwatch(fd);
+        ::close(fd);
+        fd = -1;
+        outBuf.clear();
+    }
+
+    bool isOpen() const { return fd >= 0; }
+
+private:
+    void readable() {
+        ssize_t n = ::read(fd, inBuf.data(), inBuf.size());
+        if (n > 0) {
+            onData(*this, std::span<const char>(inBuf.data(), static_cast<std::size_t>(n)));
+        }
+        else if (n == 0 || errno != EAGAIN) {
+            close(); // peer closed, or error
+        }
+    }
+
+    void writable() {
+        ssize_t n = ::send(fd, outBuf.data(), outBuf.size(), MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EAGAIN) return;
+            close(); // peer closed, or error
+            return;
+        }
+        outBuf.erase(outBuf.begin(), outBuf.begin() + n);
+        if (outBuf.empty()) reactor.setWritable(fd, {});
+    }
+
+    Reactor& reactor;
+    int fd;
+    DataHandler onData;
+    std::vector<char> inBuf;
+    std::vector<char> outBuf;
+};
+
+void makeSocketPair(int fds[2]) {
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) < 0) throwErrno("socketpair");
+}
+
+int main() {
+    std::cout << "=== epoll reactor ===\n";
+    Reactor reactor;
+
+    // 1) Plain tasks, like the queue of 11_stdFunction_2
+    int counter = 0;
+    reactor.post([&reactor, &counter]() {
+        std::cout << "[Lambda] scheduling a new task\n";
+        reactor.post([&counter]() {
+            counter += 10;
+            std::cout << "[Dynamically added lambda] counter = " << counter << "\n";
+            });
+        });
+
+    // 2) A pipe written by another thread; EOF when the writer closes it
+    int pipeFds[2];
+    if (pipe2(pipeFds, O_NONBLOCK | O_CLOEXEC) < 0) throwErrno("pipe2");
+    reactor.watch(pipeFds[0], [&reactor, fd = pipeFds[0]]() {
+        char buf[256];
+        ssize_t n = read(fd, buf, sizeof buf);
+        if (n > 0) {
+            std::cout << "[pipe] read: " << std::string(buf, static_cast<std::size_t>(n)) << "\n";
+            return;
+        }
+        if (n < 0 && errno == EAGAIN) return;
+        std::cout << "[pipe] writer closed\n";
+        reactor.unwatch(fd);
+        close(fd);
+        });
+
+    // 3) Tasks from another thread through the eventfd; the last one stops the loop
+    std::thread producer([&reactor, writeFd = pipeFds[1]]() {
+        const char msg[] = "hello from another thread";
+        ssize_t r = write(writeFd, msg, sizeof msg - 1);
+        (void)r;
+        close(writeFd);
+        reactor.postFromAnyThread([]() { std::cout << "[eventfd] task posted from another thread\n"; });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        reactor.stop();
+        });
+    reactor.run();
+    producer.join();
+
+    // -----------------------------
+    // socketpair tests
+    // -----------------------------
+    constexpr int messages = 200'000;
+    constexpr std::size_t messageSize = 32;
+    char message[messageSize] = "ping";
+
+    // Ping-pong: one message in flight; each round trip is two writes, two
+    // reads and one epoll_wait per hop
+    {
+        int fds[2];
+        makeSocketPair(fds);
+        Connection server(reactor, fds[0], [](Connection& c, std::span<const char> data) { c.send(data); }); // echo
+        std::size_t received = 0;
+        int sent = 1;
+        Connection client(reactor, fds[1], [&](Connection& c, std::span<const char> data) {
+            received += data.size();
+            if (received < std::size_t(sent) * messageSize) return;
+            if (sent == messages) {
+                reactor.stop();
+                return;
+            }
+            ++sent;
+            c.send(std::span<const char>(message, messageSize));
+            });
+
+        auto start = std::chrono::high_resolution_clock::now();
+        client.send(std::span<const char>(message, messageSize));
+        reactor.run();
+        auto end = std::chrono::high_resolution_clock::now();
+        double t = std::chrono::duration<double>(end - start).count();
+        std::cout << "\n=== socketpair, " << messages << " x " << messageSize << "-byte messages ===\n";
+        std::cout << "Ping-pong (echo, 1 in flight): " << messages / t / 1e3 << " k round trips/s ("
+            << (received == std::size_t(messages) * messageSize ? "all echoed" : "MISSING DATA") << ")\n";
+    }
+
+    // Streaming: another thread writes as fast as it can; the reactor reads
+    // whatever has arrived in one call per readiness
+    {
+        int fds[2];
+        makeSocketPair(fds);
+        std::size_t received = 0;
+        std::size_t reads = 0;
+        const std::size_t total = std::size_t(messages) * messageSize;
+        Connection sink(reactor, fds[0], [&](Connection&, std::span<const char> data) {
+            received += data.size();
+            ++reads;
+            if (received == total) reactor.stop();
+            });
+
+        auto start = std::chrono::high_resolution_clock::now();
+        std::thread writer([&]() {
+            std::vector<char> batch(64 * messageSize);
+            for (std::size_t off = 0; off < total; ) {
+                std::size_t n = std::min(batch.size(), total - off);
+                ssize_t w = write(fds[1], batch.data(), n); // blocking end
+                if (w <= 0) break;
+                off += static_cast<std::size_t>(w);
+            }
+            });
+        reactor.run();
+        auto end = std::chrono::high_resolution_clock::now();
+        writer.join();
+        close(fds[1]);
+        double t = std::chrono::duration<double>(end - start).count();
+        std::cout << "Streaming from a thread:       " << messages / t / 1e6 << " M messages/s, "
+            << double(received) / messageSize / reads << " messages per read\n";
+    }
+
+    // A large send: the kernel buffer fills up, the rest waits in the output
+    // buffer and goes out from the write callback as the peer reads
+    {
+        int fds[2];
+        makeSocketPair(fds);
+        const std::size_t size = 8 * 1024 * 1024;
+        std::vector<char> blob(size);
+        for (std::size_t i = 0; i < size; ++i) blob[i] = static_cast<char>(i * 7);
+        std::size_t received = 0;
+        bool intact = true;
+        Connection receiver(reactor, fds[0], [&](Connection&, std::span<const char> data) {
+            for (std::size_t i = 0; i < data.size(); ++i) intact &= data[i] == blob[received + i];
+            received += data.size();
+            if (received == size) reactor.stop();
+            });
+        Connection sender(reactor, fds[1], [](Connection&, std::span<const char>) {});
+        sender.send(blob);
+        reactor.run();
+        std::cout << "8 MiB through send():          " << (intact && received == size ? "received intact" : "CORRUPTED") << "\n";
+    }
+
+    // Peers that go away: no SIGPIPE, the connection just closes; a write-only
+    // watch still hears about the hang-up
+    {
+        int fds[2];
+        makeSocketPair(fds);
+        close(fds[1]);
+        Connection orphan(reactor, fds[0], [](Connection&, std::span<const char>) {});
+        orphan.send(std::span<const char>(message, messageSize));
+        std::cout << "Send to a closed peer:         connection " << (orphan.isOpen() ? "STILL OPEN" : "closed") << "\n";
+
+        int pipeEnds[2];
+        if (pipe2(pipeEnds, O_NONBLOCK | O_CLOEXEC) < 0) throwErrno("pipe2");
+        int writeEnd = pipeEnds[1];
+        char fill[4096] = {};
+        while (write(writeEnd, fill, sizeof fill) > 0) {} // full: not writable until the reader goes
+        reactor.watch(writeEnd, {}, [&reactor, writeEnd]() {
+            std::cout << "Write-only watch:              told of the closed reader\n";
+            reactor.unwatch(writeEnd);
+            close(writeEnd);
+            reactor.stop();
+            });
+        close(pipeEnds[0]);
+        reactor.run();
+    }
+
+    // Cross-thread tasks: wakeups are coalesced while one is pending
+    {
+        long long sum = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        std::size_t wakeupsBefore = reactor.wakeups();
+        std::thread poster([&]() {
+            for (int i = 1; i <= messages; ++i) {
+                reactor.postFromAnyThread([&sum, i, last = i == messages, &reactor]() {
+                    sum += i;
+                    if (last) reactor.stop();
+                    });
+            }
+            });
+        reactor.run();
+        auto end = std::chrono::high_resolution_clock::now();
+        poster.join();
+        double t = std::chrono::duration<double>(end - start).count();
+        std::cout << "postFromAnyThread:             " << messages / t / 1e6 << " M tasks/s, "
+            << reactor.wakeups() - wakeupsBefore << " eventfd wakeups ("
+            << (sum == (long long)messages * (messages + 1) / 2 ? "all ran" : "MISSING TASKS") << ")\n";
+    }
+
+    return 0;
+}
+
+#else
+
+int main() {
+    std::cout << "This example needs Linux (epoll, eventfd).\n";
+    return 0;
+}
+
+#endif